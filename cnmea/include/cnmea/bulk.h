@@ -0,0 +1,211 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <iterator>
+#include <memory_resource>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cnmea.h"
+#include "filter.h"
+#include "simd.h"
+#include "types.h"
+
+/**
+ * @namespace cnmea::bulk
+ * @brief Zero-copy parsing of whole buffers and memory-mapped log files.
+ */
+namespace cnmea::bulk {
+
+/// @brief Read-only memory mapping of a file, unmapped on destruction.
+class MappedFile {
+private:
+  const char *data{nullptr};
+  std::size_t size{0};
+
+public:
+  MappedFile() = default;
+  MappedFile(const char *data, std::size_t size) : data(data), size(size) {}
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  MappedFile(MappedFile &&other) noexcept
+      : data(std::exchange(other.data, nullptr)),
+        size(std::exchange(other.size, 0)) {}
+
+  MappedFile &operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+      unmap();
+      data = std::exchange(other.data, nullptr);
+      size = std::exchange(other.size, 0);
+    }
+    return *this;
+  }
+
+  ~MappedFile() { unmap(); }
+
+  /// @brief The whole file contents.
+  std::string_view view() const noexcept { return {data, size}; }
+
+private:
+  void unmap() noexcept {
+    if (data != nullptr) {
+      ::munmap(const_cast<char *>(data), size);
+      data = nullptr;
+    }
+  }
+};
+
+/// @brief Maps @p path read-only and hints the kernel at sequential access.
+inline std::expected<MappedFile, types::ParseError>
+map_file(const std::filesystem::path &path) noexcept {
+  int fd = ::open(path.c_str(), O_RDONLY);
+
+  if (fd < 0) {
+    return std::unexpected(types::ParseError::IOError);
+  }
+
+  struct stat info{};
+
+  if (::fstat(fd, &info) != 0) {
+    ::close(fd);
+    return std::unexpected(types::ParseError::IOError);
+  }
+
+  auto size = static_cast<std::size_t>(info.st_size);
+
+  if (size == 0) {
+    ::close(fd);
+    return MappedFile{};
+  }
+
+  void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+
+  if (data == MAP_FAILED) {
+    return std::unexpected(types::ParseError::IOError);
+  }
+
+  ::madvise(data, size, MADV_SEQUENTIAL);
+  ::madvise(data, size, MADV_WILLNEED);
+
+  return MappedFile{static_cast<const char *>(data), size};
+}
+
+/// @brief Calls @p callback with every sentence framed in @p buffer.
+///
+/// Framing follows StreamParser: a sentence starts at `$` or `!` and ends at
+/// CR, LF or the next start. Boundaries are located 64 bytes at a time with
+/// the simd kernels. The views point into @p buffer.
+template <typename Callback>
+void for_each_sentence(std::string_view buffer, Callback &&callback) {
+  std::size_t start = std::string_view::npos;
+
+  simd::for_each_block(buffer, [&](std::size_t offset, simd::Block block) {
+    simd::for_each_bit(
+        block.start | block.newline, offset, [&](std::size_t boundary) {
+          if (start != std::string_view::npos) {
+            callback(buffer.substr(start, boundary - start));
+            start = std::string_view::npos;
+          }
+          if (buffer[boundary] == '$' || buffer[boundary] == '!') {
+            start = boundary;
+          }
+        });
+  });
+
+  if (start != std::string_view::npos) {
+    callback(buffer.substr(start));
+  }
+}
+
+/// @brief Parses every sentence in @p buffer that @p filter accepts,
+/// calling `handler(const Result &)` for each. Rejected sentences are
+/// skipped before validation. Returns the number of sentences parsed.
+template <typename Handler>
+  requires std::invocable<Handler &, const Result &>
+std::size_t parse_buffer(std::string_view buffer, const Filter &filter,
+                         Handler &&handler,
+                         std::pmr::memory_resource *resource =
+                             std::pmr::get_default_resource()) {
+  std::size_t count = 0;
+  for_each_sentence(buffer, [&](std::string_view sentence) {
+    if (filter.accepts(sentence)) {
+      handler(parse(sentence, resource));
+      count++;
+    }
+  });
+  return count;
+}
+
+/// @brief Parses every sentence in @p buffer, calling
+/// `handler(const Result &)` for each. Returns the number of sentences.
+template <typename Handler>
+  requires std::invocable<Handler &, const Result &>
+std::size_t parse_buffer(std::string_view buffer, Handler &&handler,
+                         std::pmr::memory_resource *resource =
+                             std::pmr::get_default_resource()) {
+  return parse_buffer(buffer, Filter{}, handler, resource);
+}
+
+/// @brief Parses every sentence in @p buffer that @p filter accepts into an
+/// output sink.
+template <std::output_iterator<Result> Output>
+Output parse_buffer(std::string_view buffer, const Filter &filter,
+                    Output output,
+                    std::pmr::memory_resource *resource =
+                        std::pmr::get_default_resource()) {
+  for_each_sentence(buffer, [&](std::string_view sentence) {
+    if (filter.accepts(sentence)) {
+      *output++ = parse(sentence, resource);
+    }
+  });
+  return output;
+}
+
+/// @brief Parses every sentence in @p buffer into an output sink.
+template <std::output_iterator<Result> Output>
+Output parse_buffer(std::string_view buffer, Output output,
+                    std::pmr::memory_resource *resource =
+                        std::pmr::get_default_resource()) {
+  return parse_buffer(buffer, Filter{}, output, resource);
+}
+
+/// @brief Memory-maps the log at @p path and parses the sentences that
+/// @p filter accepts in place.
+template <typename Handler>
+  requires std::invocable<Handler &, const Result &>
+std::expected<std::size_t, types::ParseError>
+parse_file(const std::filesystem::path &path, const Filter &filter,
+           Handler &&handler,
+           std::pmr::memory_resource *resource =
+               std::pmr::get_default_resource()) {
+  auto file = map_file(path);
+
+  if (!file) {
+    return std::unexpected(file.error());
+  }
+
+  return parse_buffer(file->view(), filter, handler, resource);
+}
+
+/// @brief Memory-maps the log at @p path and parses it in place.
+template <typename Handler>
+  requires std::invocable<Handler &, const Result &>
+std::expected<std::size_t, types::ParseError>
+parse_file(const std::filesystem::path &path, Handler &&handler,
+           std::pmr::memory_resource *resource =
+               std::pmr::get_default_resource()) {
+  return parse_file(path, Filter{}, handler, resource);
+}
+
+} // namespace cnmea::bulk
@@ -2,6 +2,8 @@
 
 #include <cstdlib>
 #include <expected>
+#include <memory_resource>
+#include <span>
 #include <string>
 #include <variant>
 
@@ -26,25 +28,70 @@ using ZDA = zda::ZDA;
 
 using Sample = std::variant<GGA, GLL, GSA, GSV, RMC, VTG, ZDA>;
 
-inline std::expected<Sample, types::ParseError> parse(std::string_view sample) {
-  if (sample.contains("GGA")) {
-    return gga::parse(sample);
-  } else if (sample.contains("GLL")) {
-    return gll::parse(sample);
-  } else if (sample.contains("GSA")) {
-    return gsa::parse(sample);
-  } else if (sample.contains("GSV")) {
-    return gsv::parse(sample);
-  } else if (sample.contains("RMC")) {
-    return rmc::parse(sample);
-  } else if (sample.contains("VTG")) {
-    return vtg::parse(sample);
-  } else if (sample.contains("ZDA")) {
-    return zda::parse(sample);
+using Result = std::expected<Sample, types::ParseError>;
+
+/// @brief Parses any supported sentence.
+///
+/// The `$ttSSS` header is decoded once by fixed position and the sentence is
+/// validated and tokenized in a single scan; the located fields are handed
+/// straight to the matching per-type parser. Parsing never throws: every
+/// failure, including truncated or corrupt input, is a types::ParseError.
+///
+/// Variable-length members (GSA/GSV satellite lists) are allocated from
+/// @p resource, e.g. a std::pmr::monotonic_buffer_resource shared by a whole
+/// batch and released in one step.
+inline Result parse(std::string_view sample,
+                    std::pmr::memory_resource *resource =
+                        std::pmr::get_default_resource()) noexcept {
+  auto header = tools::parse_header(sample);
+
+  if (!header) {
+    return std::unexpected(header.error());
+  }
+
+  auto sentence = tools::scan(sample);
+
+  if (!sentence) {
+    return std::unexpected(sentence.error());
+  }
+
+  using enum types::Type;
+  switch (header->type) {
+  case GGA:
+    return gga::parse(header.value(), sentence->tokens);
+  case GLL:
+    return gll::parse(header.value(), sentence->tokens);
+  case GSA:
+    return gsa::parse(header.value(), sentence->tokens, resource);
+  case GSV:
+    return gsv::parse(header.value(), sentence->tokens, resource);
+  case RMC:
+    return rmc::parse(header.value(), sentence->tokens);
+  case VTG:
+    return vtg::parse(header.value(), sentence->tokens);
+  case ZDA:
+    return zda::parse(header.value(), sentence->tokens);
   }
+
   return std::unexpected(types::ParseError::UnsupportedType);
 }
 
+/// @brief Encodes any supported sentence into @p buffer, the inverse of
+/// parse(). A buffer of serialize::MAX_LENGTH suffices when every field is
+/// within the range a receiver reports; one such as an altitude of 1e300 m
+/// does not fit.
+/// @return The sentence length, or BufferOverflow when it does not fit in
+/// @p buffer.
+inline std::expected<std::size_t, types::ParseError>
+encode(const Sample &sample, std::span<char> buffer) noexcept {
+  return std::visit(
+      [buffer](const auto &data) {
+        // The per-type encoders are found by argument-dependent lookup.
+        return encode(data, buffer);
+      },
+      sample);
+}
+
 inline void print(const Sample &sample) {
   std::visit(
       []<typename T>(const T &data) {
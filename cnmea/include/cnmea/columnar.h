@@ -0,0 +1,337 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bulk.h"
+#include "epoch.h"
+#include "gga.h"
+#include "gll.h"
+#include "rmc.h"
+#include "tools.h"
+#include "types.h"
+#include "vtg.h"
+#include "zda.h"
+
+/**
+ * @namespace cnmea::columnar
+ * @brief Struct-of-arrays output for analytics over large logs.
+ *
+ * Sentences are decoded straight into one contiguous array per field,
+ * grouped per sentence type, with a validity bitmap per column. Rows of a
+ * table line up across its columns: row i of `gga.latitude` and row i of
+ * `gga.hdop` come from the same GGA sentence.
+ */
+namespace cnmea::columnar {
+
+/// @brief One field of a table: contiguous values plus a validity bitmap.
+///
+/// Bit `i % 64` of `bitmap()[i / 64]` is set when row i holds a value.
+/// Missing floating-point values are stored as NaN and missing integers as
+/// 0, so columns can be scanned without consulting the bitmap when that
+/// suffices.
+template <typename T> class Column {
+public:
+  static constexpr T MISSING = [] {
+    if constexpr (std::is_floating_point_v<T>) {
+      return std::numeric_limits<T>::quiet_NaN();
+    } else {
+      return T{};
+    }
+  }();
+
+  void push(std::optional<T> value) {
+    std::size_t row = data.size();
+
+    if (row % 64 == 0) {
+      validity.push_back(0);
+    }
+
+    if (value) {
+      validity.back() |= std::uint64_t{1} << (row % 64);
+    }
+
+    data.push_back(value.value_or(MISSING));
+  }
+
+  void reserve(std::size_t rows) {
+    data.reserve(rows);
+    validity.reserve((rows + 63) / 64);
+  }
+
+  void clear() noexcept {
+    data.clear();
+    validity.clear();
+  }
+
+  std::size_t size() const noexcept { return data.size(); }
+
+  bool valid(std::size_t row) const noexcept {
+    return (validity[row / 64] >> (row % 64)) & 1;
+  }
+
+  std::span<const T> values() const noexcept { return data; }
+  std::span<const std::uint64_t> bitmap() const noexcept { return validity; }
+
+private:
+  std::vector<T> data;
+  std::vector<std::uint64_t> validity;
+};
+
+/// @brief Columns decoded from GGA sentences.
+struct GGATable {
+  Column<std::int64_t> timestamp;   ///< UTC epoch nanoseconds
+  Column<double> latitude;          ///< Signed decimal degrees
+  Column<double> longitude;         ///< Signed decimal degrees
+  Column<double> altitude;          ///< Meters above mean sea level
+  Column<double> hdop;              ///< Horizontal dilution of precision
+  Column<std::int32_t> fix_quality; ///< types::FixQuality value
+  Column<std::int32_t> satellites;  ///< Satellites used in the fix
+
+  std::size_t size() const noexcept { return timestamp.size(); }
+  auto columns() noexcept {
+    return std::tie(timestamp, latitude, longitude, altitude, hdop,
+                    fix_quality, satellites);
+  }
+};
+
+/// @brief Columns decoded from GLL sentences.
+struct GLLTable {
+  Column<std::int64_t> timestamp; ///< UTC epoch nanoseconds
+  Column<double> latitude;        ///< Signed decimal degrees
+  Column<double> longitude;       ///< Signed decimal degrees
+
+  std::size_t size() const noexcept { return timestamp.size(); }
+  auto columns() noexcept { return std::tie(timestamp, latitude, longitude); }
+};
+
+/// @brief Columns decoded from RMC sentences.
+struct RMCTable {
+  Column<std::int64_t> timestamp; ///< UTC epoch nanoseconds
+  Column<double> latitude;        ///< Signed decimal degrees
+  Column<double> longitude;       ///< Signed decimal degrees
+  Column<double> speed;           ///< Speed over ground in knots
+  Column<double> course;          ///< Course over ground in degrees
+
+  std::size_t size() const noexcept { return timestamp.size(); }
+  auto columns() noexcept {
+    return std::tie(timestamp, latitude, longitude, speed, course);
+  }
+};
+
+/// @brief Columns decoded from VTG sentences.
+struct VTGTable {
+  Column<std::int64_t> timestamp; ///< UTC epoch nanoseconds
+  Column<double> speed;           ///< Speed over ground in knots
+  Column<double> course;          ///< True course over ground in degrees
+
+  std::size_t size() const noexcept { return timestamp.size(); }
+  auto columns() noexcept { return std::tie(timestamp, speed, course); }
+};
+
+/// @brief Tables of one parsed batch.
+struct Batch {
+  GGATable gga;
+  GLLTable gll;
+  RMCTable rmc;
+  VTGTable vtg;
+  /// Sentences that parsed but have no table (GSA, GSV, ZDA).
+  std::size_t skipped{0};
+  /// Sentences rejected by the parser, per types::ParseError value.
+  std::array<std::size_t, types::PARSE_ERRORS> errors{};
+};
+
+/// @brief Decodes sentences straight into a columnar Batch.
+///
+/// Each sentence is decoded into its stack-allocated per-type struct and
+/// appended column by column; no Sample variant is built. Timestamps come
+/// from an EpochResolver that follows the RMC/ZDA dates of the stream.
+///
+/// Example:
+/// @code
+/// cnmea::columnar::Builder builder;
+/// cnmea::bulk::for_each_sentence(log, [&](std::string_view sentence) {
+///   builder.push(sentence);
+/// });
+/// auto latitudes = builder.batch().gga.latitude.values();
+/// @endcode
+class Builder {
+public:
+  /// @brief Appends one sentence to the batch.
+  void push(std::string_view sample) {
+    auto header = tools::parse_header(sample);
+
+    if (!header) {
+      count_error(header.error());
+      return;
+    }
+
+    auto sentence = tools::scan(sample);
+
+    if (!sentence) {
+      count_error(sentence.error());
+      return;
+    }
+
+    using enum types::Type;
+    switch (header->type) {
+    case GGA:
+      append(gga::parse(header.value(), sentence->tokens));
+      return;
+    case GLL:
+      append(gll::parse(header.value(), sentence->tokens));
+      return;
+    case RMC:
+      append(rmc::parse(header.value(), sentence->tokens));
+      return;
+    case VTG:
+      append(vtg::parse(header.value(), sentence->tokens));
+      return;
+    case ZDA:
+      append(zda::parse(header.value(), sentence->tokens));
+      return;
+    case GSA:
+    case GSV:
+      output.skipped++;
+      return;
+    }
+  }
+
+  /// @brief Reserves room for @p rows sentences in every table.
+  void reserve(std::size_t rows) {
+    auto reserve_all = [rows](auto &...column) {
+      (column.reserve(rows), ...);
+    };
+    std::apply(reserve_all, output.gga.columns());
+    std::apply(reserve_all, output.gll.columns());
+    std::apply(reserve_all, output.rmc.columns());
+    std::apply(reserve_all, output.vtg.columns());
+  }
+
+  const Batch &batch() const noexcept { return output; }
+
+  /// @brief Hands over the batch and starts a new one. The timestamp
+  /// resolver keeps its date, so consecutive batches of one stream line up.
+  Batch take() { return std::exchange(output, Batch{}); }
+
+private:
+  EpochResolver resolver;
+  Batch output;
+
+  static std::optional<double> latitude(const auto &data) {
+    if (!data.latitude) {
+      return std::nullopt;
+    }
+    return data.latitude->value_degrees();
+  }
+
+  static std::optional<double> longitude(const auto &data) {
+    if (!data.longitude) {
+      return std::nullopt;
+    }
+    return data.longitude->value_degrees();
+  }
+
+  static std::optional<double> altitude(const gga::GGA &data) {
+    if (!data.altitude) {
+      return std::nullopt;
+    }
+    double value = data.altitude->get_value();
+    switch (data.altitude->get_units()) {
+    case types::DistanceUnits::km:
+      return value * 1000.0;
+    case types::DistanceUnits::ft:
+      return value * types::FTTOM;
+    case types::DistanceUnits::m:
+      break;
+    }
+    return value;
+  }
+
+  void count_error(types::ParseError error) noexcept {
+    output.errors[static_cast<std::size_t>(error)]++;
+  }
+
+  template <typename T>
+  void append(const std::expected<T, types::ParseError> &result) {
+    if (!result) {
+      count_error(result.error());
+      return;
+    }
+
+    const T &data = result.value();
+    std::optional<std::int64_t> timestamp = resolver.stamp(data);
+
+    if constexpr (std::is_same_v<T, gga::GGA>) {
+      GGATable &table = output.gga;
+      table.timestamp.push(timestamp);
+      table.latitude.push(latitude(data));
+      table.longitude.push(longitude(data));
+      table.altitude.push(altitude(data));
+      table.hdop.push(data.hdop);
+      table.fix_quality.push(static_cast<std::int32_t>(data.fix_quality));
+      table.satellites.push(data.num_satellites);
+    } else if constexpr (std::is_same_v<T, gll::GLL>) {
+      GLLTable &table = output.gll;
+      table.timestamp.push(timestamp);
+      table.latitude.push(latitude(data));
+      table.longitude.push(longitude(data));
+    } else if constexpr (std::is_same_v<T, rmc::RMC>) {
+      RMCTable &table = output.rmc;
+      table.timestamp.push(timestamp);
+      table.latitude.push(latitude(data));
+      table.longitude.push(longitude(data));
+      table.speed.push(data.speed ? std::optional{data.speed->get_value()}
+                                  : std::nullopt);
+      table.course.push(data.course
+                            ? std::optional{data.course->value_degrees()}
+                            : std::nullopt);
+    } else if constexpr (std::is_same_v<T, vtg::VTG>) {
+      VTGTable &table = output.vtg;
+      table.timestamp.push(timestamp);
+      table.speed.push(data.speed_knots
+                           ? std::optional{data.speed_knots->get_value()}
+                           : std::nullopt);
+      table.course.push(data.course_true
+                            ? std::optional{data.course_true->value_degrees()}
+                            : std::nullopt);
+    } else {
+      // ZDA only feeds the timestamp resolver.
+      output.skipped++;
+    }
+  }
+};
+
+/// @brief Parses every sentence in @p buffer into a columnar Batch.
+inline Batch parse_buffer(std::string_view buffer) {
+  Builder builder;
+  bulk::for_each_sentence(
+      buffer, [&](std::string_view sentence) { builder.push(sentence); });
+  return builder.take();
+}
+
+/// @brief Memory-maps the log at @p path and parses it into a columnar
+/// Batch.
+inline std::expected<Batch, types::ParseError>
+parse_file(const std::filesystem::path &path) {
+  auto file = bulk::map_file(path);
+
+  if (!file) {
+    return std::unexpected(file.error());
+  }
+
+  return parse_buffer(file->view());
+}
+
+} // namespace cnmea::columnar
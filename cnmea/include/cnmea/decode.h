@@ -0,0 +1,279 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <expected>
+#include <string_view>
+#include <system_error>
+
+#include "types.h"
+
+/**
+ * @namespace cnmea::decode
+ * @brief Allocation-free decoders for the numeric field shapes used by NMEA.
+ *
+ * Every decoder consumes the whole token and reports failures through
+ * std::expected: an empty token is ParseError::MissingFields, anything that is
+ * not entirely a number is ParseError::InvalidFormat.
+ */
+namespace cnmea::decode {
+
+/// @brief Exact powers of ten representable as a double.
+constexpr std::array<double, 23> POW10 = [] {
+  std::array<double, 23> table{};
+  double value = 1.0;
+  for (double &entry : table) {
+    entry = value;
+    value *= 10.0;
+  }
+  return table;
+}();
+
+/// @brief Largest mantissa that a double holds exactly (2^53).
+constexpr std::uint64_t MAX_EXACT_MANTISSA{std::uint64_t{1} << 53};
+
+/// @brief A decimal number split into an integer mantissa and a scale,
+/// so that value = mantissa / 10^scale.
+struct Decimal {
+  std::uint64_t mantissa; ///< All digits, with the decimal point removed
+  int scale;              ///< Number of digits after the decimal point
+  bool negative;          ///< Leading minus sign
+};
+
+/// @brief Decodes an integer field such as "08" or "-05".
+template <std::integral T>
+std::expected<T, types::ParseError> integer(std::string_view token) noexcept {
+  if (token.empty()) {
+    return std::unexpected(types::ParseError::MissingFields);
+  }
+
+  if (token.front() == '+') {
+    token.remove_prefix(1);
+    // from_chars would take the '-' of "+-5".
+    if (token.starts_with('-')) {
+      return std::unexpected(types::ParseError::InvalidFormat);
+    }
+  }
+
+  T value{};
+  auto [end, error] =
+      std::from_chars(token.data(), token.data() + token.size(), value);
+
+  if (error != std::errc{} || end != token.data() + token.size()) {
+    return std::unexpected(types::ParseError::InvalidFormat);
+  }
+
+  return value;
+}
+
+/// @brief Splits "[-]ddd[.ddd]" into mantissa and scale without rounding.
+inline std::expected<Decimal, types::ParseError>
+decimal(std::string_view token) noexcept {
+  if (token.empty()) {
+    return std::unexpected(types::ParseError::MissingFields);
+  }
+
+  Decimal result{0, 0, false};
+
+  if (token.front() == '-' || token.front() == '+') {
+    result.negative = token.front() == '-';
+    token.remove_prefix(1);
+  }
+
+  bool seen_point = false;
+  int digits = 0;
+
+  for (char c : token) {
+    if (c == '.' && !seen_point) {
+      seen_point = true;
+    } else if (c >= '0' && c <= '9') {
+      // 19 digits always fit in 64 bits.
+      if (++digits > 19) {
+        return std::unexpected(types::ParseError::InvalidFormat);
+      }
+      result.mantissa = result.mantissa * 10 + static_cast<unsigned>(c - '0');
+      result.scale += seen_point ? 1 : 0;
+    } else {
+      return std::unexpected(types::ParseError::InvalidFormat);
+    }
+  }
+
+  if (digits == 0) {
+    return std::unexpected(types::ParseError::InvalidFormat);
+  }
+
+  return result;
+}
+
+/// @brief Slow path of fixed_decimal() for inputs that decimal() cannot
+/// represent exactly: more than 19 digits, or a mantissa beyond 2^53.
+/// Accepts the same shapes as decimal(); "inf" and "nan" are rejected.
+inline std::expected<double, types::ParseError>
+long_decimal(std::string_view token) noexcept {
+  if (token.starts_with('+')) {
+    token.remove_prefix(1);
+    if (token.starts_with('-')) {
+      return std::unexpected(types::ParseError::InvalidFormat);
+    }
+  }
+
+  double value{};
+  auto [end, error] =
+      std::from_chars(token.data(), token.data() + token.size(), value,
+                      std::chars_format::fixed);
+
+  if (error != std::errc{} || end != token.data() + token.size() ||
+      !std::isfinite(value)) {
+    return std::unexpected(types::ParseError::InvalidFormat);
+  }
+
+  return value;
+}
+
+/// @brief Decodes a fixed-point decimal field such as "2.0" or "-12.345".
+///
+/// When the digits fit in a double mantissa the value is computed with a
+/// single, correctly rounded division; longer inputs fall back to
+/// std::from_chars.
+inline std::expected<double, types::ParseError>
+fixed_decimal(std::string_view token) noexcept {
+  auto parts = decimal(token);
+
+  if (!parts) {
+    if (parts.error() == types::ParseError::MissingFields) {
+      return std::unexpected(parts.error());
+    }
+    return long_decimal(token);
+  }
+
+  if (parts->mantissa >= MAX_EXACT_MANTISSA ||
+      parts->scale >= static_cast<int>(POW10.size())) {
+    return long_decimal(token);
+  }
+
+  double value = static_cast<double>(parts->mantissa) / POW10[parts->scale];
+  return parts->negative ? -value : value;
+}
+
+/// @brief Decodes a DDMM.mmmm / DDDMM.mmmm coordinate into decimal degrees.
+///
+/// Degrees and minutes are separated on the integer mantissa, so the only
+/// rounding happens in the final division.
+inline std::expected<double, types::ParseError>
+coordinate(std::string_view token) noexcept {
+  auto parts = decimal(token);
+
+  if (!parts) {
+    return std::unexpected(parts.error());
+  }
+
+  // Beyond 15 fractional digits 100 * 10^scale no longer fits in 64 bits.
+  if (parts->negative || parts->mantissa >= MAX_EXACT_MANTISSA ||
+      parts->scale > 15) {
+    return std::unexpected(types::ParseError::InvalidFormat);
+  }
+
+  auto unit = static_cast<std::uint64_t>(POW10[parts->scale]);
+  std::uint64_t degrees = parts->mantissa / (100 * unit);
+  std::uint64_t minutes = parts->mantissa % (100 * unit);
+
+  if (minutes >= 60 * unit) {
+    return std::unexpected(types::ParseError::InvalidFormat);
+  }
+
+  return static_cast<double>(degrees) +
+         static_cast<double>(minutes) / (60.0 * POW10[parts->scale]);
+}
+
+/// @brief Decodes the two ASCII digits of @p token starting at @p at.
+/// Returns -1 when either character is not a digit.
+constexpr int two_digits(std::string_view token, std::size_t at) noexcept {
+  unsigned tens = static_cast<unsigned>(token[at] - '0');
+  unsigned ones = static_cast<unsigned>(token[at + 1] - '0');
+  return tens > 9 || ones > 9 ? -1 : static_cast<int>(tens * 10 + ones);
+}
+
+/// @brief Decodes an hhmmss[.s...] time field.
+///
+/// Up to nine fractional digits are kept as nanoseconds; further digits are
+/// truncated. Malformed or out-of-range fields are
+/// ParseError::InvalidUTCTime.
+inline std::expected<types::UTCTime, types::ParseError>
+utc_time(std::string_view token) noexcept {
+  if (token.empty()) {
+    return std::unexpected(types::ParseError::MissingFields);
+  }
+
+  if (token.size() < 6 || (token.size() > 6 && token[6] != '.')) {
+    return std::unexpected(types::ParseError::InvalidUTCTime);
+  }
+
+  int hours = two_digits(token, 0);
+  int minutes = two_digits(token, 2);
+  int seconds = two_digits(token, 4);
+
+  // Seconds may reach 60 during a leap second.
+  if (hours < 0 || hours > 23 || minutes < 0 || minutes > 59 || seconds < 0 ||
+      seconds > 60) {
+    return std::unexpected(types::ParseError::InvalidUTCTime);
+  }
+
+  std::uint32_t nanoseconds = 0;
+  int digits = 0;
+
+  for (char c : token.substr(std::min<std::size_t>(token.size(), 7))) {
+    if (c < '0' || c > '9') {
+      return std::unexpected(types::ParseError::InvalidUTCTime);
+    }
+    if (digits < 9) {
+      nanoseconds = nanoseconds * 10 + static_cast<unsigned>(c - '0');
+      digits++;
+    }
+  }
+
+  nanoseconds *= static_cast<std::uint32_t>(POW10[9 - digits]);
+
+  return types::UTCTime{static_cast<std::uint8_t>(hours),
+                        static_cast<std::uint8_t>(minutes),
+                        static_cast<std::uint8_t>(seconds), nanoseconds};
+}
+
+/// @brief Decodes a ddmmyy date field.
+///
+/// Two-digit years are placed in 1980-2079, the span that starts at the GPS
+/// epoch. Invalid calendar dates are ParseError::InvalidUTCDate.
+inline std::expected<types::UTCDate, types::ParseError>
+utc_date(std::string_view token) noexcept {
+  if (token.empty()) {
+    return std::unexpected(types::ParseError::MissingFields);
+  }
+
+  if (token.size() != 6) {
+    return std::unexpected(types::ParseError::InvalidUTCDate);
+  }
+
+  int day = two_digits(token, 0);
+  int month = two_digits(token, 2);
+  int year = two_digits(token, 4);
+
+  if (day < 0 || month < 0 || year < 0) {
+    return std::unexpected(types::ParseError::InvalidUTCDate);
+  }
+
+  types::UTCDate date{static_cast<std::uint8_t>(day),
+                      static_cast<std::uint8_t>(month),
+                      static_cast<std::uint16_t>(year < 80 ? 2000 + year
+                                                           : 1900 + year)};
+
+  if (!date.to_year_month_day().ok()) {
+    return std::unexpected(types::ParseError::InvalidUTCDate);
+  }
+
+  return date;
+}
+
+} // namespace cnmea::decode
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "cnmea.h"
+#include "types.h"
+
+namespace cnmea {
+
+/// @brief A parsed sentence and its absolute UTC timestamp.
+struct Stamped {
+  Sample sample;
+  /// Nanoseconds since the Unix epoch; empty until a date has been seen.
+  std::optional<std::int64_t> epoch_ns;
+};
+
+/// @brief Turns the time-of-day fields of a sentence stream into absolute
+/// UTC timestamps.
+///
+/// Only RMC and ZDA carry a date. The resolver caches the last one as the
+/// nanosecond epoch of its midnight, computed once per date change, so
+/// stamping any other sentence is a single addition. When the time of day
+/// jumps back by more than half a day the stream has crossed midnight and the
+/// cached day advances without waiting for the next dated sentence. A dated
+/// sentence still sets the day to its own date, even one that arrives after
+/// such a rollover but was sent before midnight.
+/// Sentences without a time (GSA, GSV, VTG) get the timestamp of the last
+/// timed sentence, i.e. of the epoch they were sent in.
+///
+/// Example:
+/// @code
+/// cnmea::EpochResolver resolver;
+///
+/// for (std::string_view line : lines) {
+///   if (auto stamped = resolver.parse(line); stamped && stamped->epoch_ns) {
+///     store(*stamped->epoch_ns, stamped->sample);
+///   }
+/// }
+/// @endcode
+class EpochResolver {
+public:
+  static constexpr std::int64_t NS_PER_DAY{86'400'000'000'000};
+
+  /// @brief Sets the current date. Calendar maths only runs when @p date
+  /// differs from the cached one.
+  void set_date(const types::UTCDate &date) noexcept {
+    if (!has_date || date != cached_date) {
+      auto ymd = date.to_year_month_day();
+      if (!ymd.ok()) {
+        return;
+      }
+
+      cached_date = date;
+      date_ns =
+          std::chrono::sys_days{ymd}.time_since_epoch().count() * NS_PER_DAY;
+    }
+
+    // Compared with the current day, not the cached date: stamp() may have
+    // moved the day past midnight since that date was seen.
+    if (has_date && day_ns == date_ns) {
+      return;
+    }
+
+    has_date = true;
+    day_ns = date_ns;
+    // The new date already covers any midnight since the last time of day.
+    last_time_ns = -1;
+  }
+
+  /// @brief Stamps a time of day against the cached date.
+  std::optional<std::int64_t> stamp(const types::UTCTime &time) noexcept {
+    std::int64_t time_ns = time.to_duration().count();
+
+    if (last_time_ns >= 0 && last_time_ns - time_ns > NS_PER_DAY / 2) {
+      day_ns += NS_PER_DAY;
+    }
+    last_time_ns = time_ns;
+
+    if (!has_date) {
+      return std::nullopt;
+    }
+
+    last_epoch_ns = day_ns + time_ns;
+    return last_epoch_ns;
+  }
+
+  /// @brief Updates the cached date from RMC/ZDA and stamps one decoded
+  /// sentence, e.g. a gga::GGA.
+  template <typename T>
+  std::optional<std::int64_t> stamp(const T &data) noexcept {
+    if constexpr (std::is_same_v<T, RMC>) {
+      if (data.utc_date) {
+        set_date(data.utc_date.value());
+      }
+    } else if constexpr (std::is_same_v<T, ZDA>) {
+      if (data.year > 0) {
+        set_date({static_cast<std::uint8_t>(data.day),
+                  static_cast<std::uint8_t>(data.month),
+                  static_cast<std::uint16_t>(data.year)});
+      }
+    }
+
+    if constexpr (requires { data.utc_time; }) {
+      if (data.utc_time) {
+        return stamp(data.utc_time.value());
+      }
+    }
+
+    return last_epoch_ns;
+  }
+
+  /// @brief Updates the cached date from RMC/ZDA and stamps @p sample.
+  std::optional<std::int64_t> stamp(const Sample &sample) noexcept {
+    return std::visit(
+        [this](const auto &data) -> std::optional<std::int64_t> {
+          return stamp(data);
+        },
+        sample);
+  }
+
+  /// @brief Parses @p sample and stamps the result.
+  std::expected<Stamped, types::ParseError>
+  parse(std::string_view sample, std::pmr::memory_resource *resource =
+                                     std::pmr::get_default_resource()) noexcept {
+    auto result = cnmea::parse(sample, resource);
+
+    if (!result) {
+      return std::unexpected(result.error());
+    }
+
+    auto epoch_ns = stamp(result.value());
+    return Stamped{std::move(result.value()), epoch_ns};
+  }
+
+  /// @brief Forgets the cached date and time, e.g. when switching streams.
+  void reset() noexcept { *this = EpochResolver{}; }
+
+private:
+  types::UTCDate cached_date{};
+  std::int64_t date_ns{0}; ///< Midnight of cached_date
+  bool has_date{false};
+  std::int64_t day_ns{0}; ///< Midnight of the current day
+  std::int64_t last_time_ns{-1};
+  std::optional<std::int64_t> last_epoch_ns;
+};
+
+} // namespace cnmea
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "tools.h"
+#include "types.h"
+
+namespace cnmea {
+
+/// @brief Selects sentences before they are validated or decoded.
+///
+/// A filter restricts the sentence types and talkers to accept and adds
+/// conditions on raw fields of a given type: a field that must be present,
+/// or a field whose first character must belong to a set. accepts() decides
+/// from the fixed-position header and, for conditions, by locating single
+/// fields by their commas; no checksum is computed and no number decoded, so
+/// rejecting a sentence costs a fraction of parsing it. A default filter
+/// accepts everything.
+///
+/// Field indices count the header as field 0, as in the per-type parsers.
+///
+/// Example:
+/// @code
+/// cnmea::Filter filter;
+/// filter.only_types({cnmea::types::Type::GGA, cnmea::types::Type::RMC})
+///     .match(cnmea::types::Type::RMC, 2, "A")   // status valid
+///     .match(cnmea::types::Type::GGA, 6, "45"); // RTK fixed or float
+/// cnmea::bulk::parse_buffer(log, filter, handler);
+/// @endcode
+class Filter {
+public:
+  /// @brief Accepts only sentences of the listed types.
+  Filter &only_types(std::initializer_list<types::Type> accepted) noexcept {
+    type_mask = 0;
+    for (types::Type type : accepted) {
+      type_mask |= bit(type);
+    }
+    return *this;
+  }
+
+  /// @brief Accepts only sentences from the listed talkers.
+  Filter &
+  only_talkers(std::initializer_list<types::Talker> accepted) noexcept {
+    talker_mask = 0;
+    for (types::Talker talker : accepted) {
+      talker_mask |= bit(talker);
+    }
+    return *this;
+  }
+
+  /// @brief Sentences of @p type must carry a non-empty field @p index.
+  Filter &require(types::Type type, std::size_t index) {
+    conditions.push_back({type, index, std::bitset<256>{}.set()});
+    return *this;
+  }
+
+  /// @brief Sentences of @p type must carry field @p index, starting with
+  /// one of the characters in @p accepted.
+  Filter &match(types::Type type, std::size_t index,
+                std::string_view accepted) {
+    Condition condition{type, index, {}};
+    for (char c : accepted) {
+      condition.accepted.set(static_cast<unsigned char>(c));
+    }
+    conditions.push_back(condition);
+    return *this;
+  }
+
+  /// @brief Whether the filter accepts every sentence.
+  bool empty() const noexcept {
+    return type_mask == ALL && talker_mask == ALL && conditions.empty();
+  }
+
+  /// @brief Whether a sentence with @p header passes the type and talker
+  /// restrictions.
+  bool accepts(const types::Header &header) const noexcept {
+    return (type_mask & bit(header.type)) != 0 &&
+           (talker_mask & bit(header.talker)) != 0;
+  }
+
+  /// @brief Whether @p sentence passes the filter. Sentences whose header
+  /// cannot be decoded pass only an empty filter, so that parsing reports
+  /// them.
+  bool accepts(std::string_view sentence) const noexcept {
+    if (empty()) {
+      return true;
+    }
+
+    auto header = tools::parse_header(sentence);
+
+    if (!header || !accepts(header.value())) {
+      return false;
+    }
+
+    for (const Condition &condition : conditions) {
+      if (condition.type != header->type) {
+        continue;
+      }
+
+      auto value = field(sentence, condition.index);
+
+      if (!value || value->empty() ||
+          !condition.accepted.test(
+              static_cast<unsigned char>(value->front()))) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+private:
+  static constexpr std::uint32_t ALL{~std::uint32_t{0}};
+
+  struct Condition {
+    types::Type type;
+    std::size_t index;
+    std::bitset<256> accepted;
+  };
+
+  std::uint32_t type_mask{ALL};
+  std::uint32_t talker_mask{ALL};
+  std::vector<Condition> conditions;
+
+  template <typename Enum> static constexpr std::uint32_t bit(Enum value) {
+    return std::uint32_t{1} << static_cast<unsigned>(value);
+  }
+
+  /// Raw field @p index, located by counting commas; no validation.
+  static std::optional<std::string_view> field(std::string_view sentence,
+                                               std::size_t index) noexcept {
+    std::size_t begin = 0;
+
+    for (std::size_t i = 0; i < index; i++) {
+      begin = sentence.find(',', begin);
+      if (begin == std::string_view::npos) {
+        return std::nullopt;
+      }
+      begin++;
+    }
+
+    std::size_t end = sentence.find_first_of(",*", begin);
+    return sentence.substr(begin, end - begin);
+  }
+};
+
+} // namespace cnmea
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+#include "cnmea.h"
+#include "epoch.h"
+#include "types.h"
+
+namespace cnmea {
+
+/// @brief The navigation solution of one epoch, merged from every sentence
+/// the receiver sent for it.
+struct Fix {
+  /// @brief GSA lists at most 12 satellites per talker; three talkers
+  /// (e.g. GP, GL, GA) cover multi-constellation receivers.
+  static constexpr std::size_t CAPACITY{36};
+
+  std::optional<types::UTCTime> utc_time; ///< Time of the epoch
+  std::optional<types::UTCDate> utc_date; ///< From RMC or ZDA
+  /// Nanoseconds since the Unix epoch; empty until a date has been seen.
+  std::optional<std::int64_t> epoch_ns;
+
+  std::optional<types::Latitude> latitude;   ///< From GGA, RMC or GLL
+  std::optional<types::Longitude> longitude; ///< From GGA, RMC or GLL
+  std::optional<types::Altitude> altitude;   ///< From GGA
+  std::optional<types::GeoidSeparation> geoid_separation; ///< From GGA
+
+  std::optional<types::FixQuality> fix_quality; ///< From GGA
+  std::optional<types::FixType> fix_type;       ///< From GSA
+  std::optional<types::Status> status;          ///< From RMC or GLL
+  std::optional<types::Mode> mode;              ///< From RMC, GLL or VTG
+
+  std::optional<types::Speed> speed;   ///< Speed over ground, from RMC or VTG
+  std::optional<types::Course> course; ///< True course, from RMC or VTG
+  std::optional<types::MagneticVariation> magnetic_variation; ///< From RMC
+
+  std::optional<types::DOP> dop; ///< From GSA
+  std::optional<double> hdop;    ///< From GSA, else GGA
+  std::optional<int> satellites; ///< Satellites used, as reported by GGA
+
+  std::size_t used_count{0};             ///< PRNs stored in `used_prns`
+  std::array<int, CAPACITY> used_prns{}; ///< PRNs of satellites used (GSA)
+
+  /// Bit `1 << types::Type` is set for every sentence type merged in.
+  std::uint32_t sources{0};
+
+  /// @brief PRNs of the satellites used in the solution.
+  std::span<const int> used() const noexcept {
+    return {used_prns.data(), used_count};
+  }
+
+  /// @brief Whether a sentence of @p type contributed to the fix.
+  bool has(types::Type type) const noexcept {
+    return (sources >> static_cast<unsigned>(type)) & 1;
+  }
+};
+
+/// @brief Merges the sentences of each epoch into a single Fix.
+///
+/// A receiver reports one solution as a burst of GGA, RMC, GSA, VTG, ZDA
+/// and GLL sentences sharing one UTC time. The aggregator writes each
+/// sentence into the Fix of the current epoch as it arrives. A sentence
+/// with a different time closes that epoch: the finished Fix is returned
+/// and the next one is started in a second preallocated slot, so completing
+/// an epoch is O(1) and nothing is allocated. Sentences without a time (GSA,
+/// VTG) belong to the epoch in progress. GSV is left to SkyViewAssembler.
+///
+/// A returned Fix stays valid until the next epoch completes.
+///
+/// Example:
+/// @code
+/// cnmea::FixAggregator aggregator;
+///
+/// for (std::string_view line : lines) {
+///   if (auto fix = aggregator.push(line); fix && *fix) {
+///     publish(**fix);
+///   }
+/// }
+/// if (const cnmea::Fix *last = aggregator.flush()) {
+///   publish(*last);
+/// }
+/// @endcode
+class FixAggregator {
+public:
+  /// @brief Merges one decoded sentence.
+  /// @return The previous epoch's Fix when @p data starts a new epoch,
+  /// otherwise nullptr.
+  template <typename T>
+    requires std::is_constructible_v<Sample, const T &>
+  const Fix *push(const T &data) noexcept {
+    if constexpr (std::is_same_v<T, GSV>) {
+      return nullptr;
+    }
+
+    const Fix *completed = nullptr;
+
+    if constexpr (requires { data.utc_time; }) {
+      if (data.utc_time) {
+        completed = begin(data.utc_time.value());
+      }
+    }
+
+    Fix &fix = fixes[active];
+    merge(fix, data);
+    fix.sources |= std::uint32_t{1} << static_cast<unsigned>(data.type);
+
+    if (auto epoch_ns = resolver.stamp(data); epoch_ns && fix.utc_time) {
+      fix.epoch_ns = epoch_ns;
+    }
+
+    return completed;
+  }
+
+  /// @brief Merges one parsed sentence.
+  const Fix *push(const Sample &sample) noexcept {
+    return std::visit(
+        [this](const auto &data) -> const Fix * { return push(data); },
+        sample);
+  }
+
+  /// @brief Parses and merges @p sample.
+  /// @return The completed Fix, nullptr while the epoch is open, or the
+  /// parse error.
+  std::expected<const Fix *, types::ParseError>
+  push(std::string_view sample, std::pmr::memory_resource *resource =
+                                    std::pmr::get_default_resource()) noexcept {
+    auto result = cnmea::parse(sample, resource);
+
+    if (!result) {
+      return std::unexpected(result.error());
+    }
+
+    return push(result.value());
+  }
+
+  /// @brief Closes the epoch in progress, e.g. at end of input.
+  /// @return Its Fix, or nullptr when no sentence has been merged since the
+  /// last epoch completed.
+  const Fix *flush() noexcept {
+    if (fixes[active].sources == 0) {
+      return nullptr;
+    }
+    return rotate();
+  }
+
+  /// @brief The Fix of the epoch in progress.
+  const Fix &current() const noexcept { return fixes[active]; }
+
+  /// @brief Drops the epoch in progress and the cached date.
+  void reset() noexcept { *this = FixAggregator{}; }
+
+private:
+  std::array<Fix, 2> fixes{};
+  std::size_t active{0};
+  EpochResolver resolver;
+
+  /// Starts a new epoch when @p time differs from the current one.
+  const Fix *begin(const types::UTCTime &time) noexcept {
+    Fix &fix = fixes[active];
+
+    if (fix.utc_time && fix.utc_time.value() == time) {
+      return nullptr;
+    }
+
+    // Untimed sentences received before any timed one join this epoch.
+    const Fix *completed = nullptr;
+    if (fix.utc_time) {
+      completed = rotate();
+    }
+
+    fixes[active].utc_time = time;
+    return completed;
+  }
+
+  const Fix *rotate() noexcept {
+    const Fix *completed = &fixes[active];
+    active ^= 1;
+    fixes[active] = Fix{};
+    return completed;
+  }
+
+  static void add_used(Fix &fix, const types::Satellite &satellite) noexcept {
+    if (fix.used_count < Fix::CAPACITY) {
+      fix.used_prns[fix.used_count++] = satellite.prn;
+    }
+  }
+
+  template <typename T> static void merge(Fix &fix, const T &data) noexcept {
+    if constexpr (std::is_same_v<T, GGA>) {
+      fix.latitude = data.latitude;
+      fix.longitude = data.longitude;
+      fix.altitude = data.altitude;
+      fix.geoid_separation = data.geoid_separation;
+      fix.fix_quality = data.fix_quality;
+      fix.satellites = data.num_satellites;
+      if (!fix.dop) {
+        fix.hdop = data.hdop;
+      }
+    } else if constexpr (std::is_same_v<T, RMC>) {
+      fix.latitude = data.latitude;
+      fix.longitude = data.longitude;
+      fix.status = data.status;
+      fix.speed = data.speed;
+      fix.course = data.course;
+      fix.magnetic_variation = data.magnetic_variation;
+      if (data.utc_date) {
+        fix.utc_date = data.utc_date;
+      }
+      if (data.mode) {
+        fix.mode = data.mode;
+      }
+    } else if constexpr (std::is_same_v<T, GLL>) {
+      if (!fix.latitude) {
+        fix.latitude = data.latitude;
+        fix.longitude = data.longitude;
+      }
+      fix.status = data.status;
+      if (data.mode) {
+        fix.mode = data.mode;
+      }
+    } else if constexpr (std::is_same_v<T, GSA>) {
+      fix.fix_type = data.fix_type;
+      if (data.dop) {
+        fix.dop = data.dop;
+        fix.hdop = data.dop->hdop;
+      }
+      for (const types::Satellite &satellite : data.satellites) {
+        add_used(fix, satellite);
+      }
+    } else if constexpr (std::is_same_v<T, VTG>) {
+      if (data.speed_knots) {
+        fix.speed = data.speed_knots;
+      }
+      if (data.course_true) {
+        fix.course = data.course_true;
+      }
+      if (data.mode) {
+        fix.mode = data.mode;
+      }
+    } else if constexpr (std::is_same_v<T, ZDA>) {
+      if (data.year > 0) {
+        fix.utc_date = types::UTCDate{static_cast<std::uint8_t>(data.day),
+                                      static_cast<std::uint8_t>(data.month),
+                                      static_cast<std::uint16_t>(data.year)};
+      }
+    }
+  }
+};
+
+} // namespace cnmea
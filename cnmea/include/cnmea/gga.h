@@ -4,15 +4,20 @@
 #include <optional>
 #include <print>
 
+#include "decode.h"
 #include "p_tools.h"
+#include "schema.h"
+#include "serialize.h"
 #include "tools.h"
 #include "types.h"
+#include "view.h"
 
 namespace cnmea::gga {
 
 struct GGA {
   types::Type type;
-  types::UTCTime utc_time;
+  types::Talker talker;
+  std::optional<types::UTCTime> utc_time;
   std::optional<types::Latitude> latitude;
   std::optional<types::Longitude> longitude;
   types::FixQuality fix_quality;
@@ -22,36 +27,119 @@ struct GGA {
   std::optional<types::GeoidSeparation> geoid_separation;
   std::optional<types::AgeOfDgps> age_of_dgps;
   std::optional<types::DgpsStationId> dgps_station_id;
+
+  bool operator==(const GGA &) const = default;
 };
 
-inline std::expected<GGA, types::ParseError> parse(std::string_view sample) {
-  if (!tools::is_valid_sample(sample)) {
-    return std::unexpected(types::ParseError::InvalidFormat);
+/// @brief Field layout; MIN_FIELDS and the parsers are generated from it.
+using Layout = schema::Layout<
+    GGA, types::Type::GGA,
+    schema::Field<&GGA::utc_time, &tools::parse_utc_time, 1>,
+    schema::Field<&GGA::latitude, &tools::parse_latitude, 2, 3>,
+    schema::Field<&GGA::longitude, &tools::parse_longitude, 4, 5>,
+    schema::Field<&GGA::fix_quality, &tools::parse_fix_quality, 6>,
+    schema::Field<&GGA::num_satellites,
+                  schema::value_or<&decode::integer<int>, 0>, 7>,
+    schema::Field<&GGA::hdop,
+                  schema::value_or<&tools::parse_numeric_value, 0.0>, 8>,
+    schema::Field<&GGA::altitude, &tools::parse_altitude, 9, 10>,
+    schema::Field<&GGA::geoid_separation, &tools::parse_geoid_separation, 11,
+                  12>,
+    schema::Field<&GGA::age_of_dgps, &tools::parse_age_of_dgps, 13>,
+    schema::Field<&GGA::dgps_station_id, &tools::parse_dgps_station_id, 14>>;
+
+/// @brief Minimum number of fields, header included.
+/// Fields up to the DGPS station ID are mandatory.
+constexpr std::size_t MIN_FIELDS{Layout::MIN_FIELDS};
+
+inline std::expected<GGA, types::ParseError>
+parse(const types::Header &header, const tools::Tokens &tokens) noexcept {
+  return Layout::parse(header, tokens);
+}
+
+inline std::expected<GGA, types::ParseError>
+parse(std::string_view sample) noexcept {
+  return Layout::parse(sample);
+}
+
+/// @brief Writes @p data into @p buffer as a complete sentence, checksum
+/// and CRLF included, without allocating.
+/// @return The sentence length, or BufferOverflow when @p buffer is too
+/// small.
+inline std::expected<std::size_t, types::ParseError>
+encode(const GGA &data, std::span<char> buffer) noexcept {
+  serialize::SentenceWriter out{buffer};
+  out.begin(data.talker, data.type);
+  out.time(data.utc_time);
+  out.latitude(data.latitude);
+  out.longitude(data.longitude);
+  out.integer(static_cast<int>(data.fix_quality));
+  out.integer(data.num_satellites, 2);
+  out.number(data.hdop);
+  if (data.altitude) {
+    out.number(data.altitude->get_value());
+    out.field(serialize::units_code(data.altitude->get_units()));
+  } else {
+    out.empty();
+    out.empty();
+  }
+  if (data.geoid_separation) {
+    out.number(data.geoid_separation->get_value());
+    out.field(serialize::units_code(data.geoid_separation->get_units()));
+  } else {
+    out.empty();
+    out.empty();
   }
+  if (data.age_of_dgps) {
+    out.number(data.age_of_dgps->value_seconds());
+  } else {
+    out.empty();
+  }
+  if (data.dgps_station_id) {
+    out.integer(data.dgps_station_id->value(), 4);
+  } else {
+    out.empty();
+  }
+  return out.finish();
+}
 
-  auto tokens = tools::tokenize(sample);
+/// @brief GGA sentence decoded field by field on access; see SentenceView.
+class View : public SentenceView<Layout> {
+public:
+  using SentenceView::SentenceView;
 
-  if (tokens.empty()) {
-    return std::unexpected(types::ParseError::UnknownError);
+  decltype(auto) utc_time() const noexcept { return get<&GGA::utc_time>(); }
+  decltype(auto) latitude() const noexcept { return get<&GGA::latitude>(); }
+  decltype(auto) longitude() const noexcept { return get<&GGA::longitude>(); }
+  decltype(auto) fix_quality() const noexcept {
+    return get<&GGA::fix_quality>();
+  }
+  decltype(auto) num_satellites() const noexcept {
+    return get<&GGA::num_satellites>();
   }
+  decltype(auto) hdop() const noexcept { return get<&GGA::hdop>(); }
+  decltype(auto) altitude() const noexcept { return get<&GGA::altitude>(); }
+  decltype(auto) geoid_separation() const noexcept {
+    return get<&GGA::geoid_separation>();
+  }
+  decltype(auto) age_of_dgps() const noexcept {
+    return get<&GGA::age_of_dgps>();
+  }
+  decltype(auto) dgps_station_id() const noexcept {
+    return get<&GGA::dgps_station_id>();
+  }
+};
 
-  return GGA{
-      tools::parse_type(tokens.at(0)),
-      tools::parse_utc_time(tokens.at(1)),
-      tools::parse_latitude(tokens.at(2), tokens.at(3)),
-      tools::parse_longitude(tokens.at(4), tokens.at(5)),
-      tools::parse_fix_quality(tokens.at(6)),
-      static_cast<int>(tools::parse_numeric_value(tokens.at(7)).value_or(0)),
-      tools::parse_numeric_value(tokens.at(8)).value_or(0.0),
-      tools::parse_altitude(tokens.at(9), tokens.at(10)),
-      tools::parse_geoid_separation(tokens.at(11), tokens.at(12)),
-      tools::parse_age_of_dgps(tokens.at(13)),
-      tools::parse_dgps_station_id(tokens.at(14)),
-  };
+/// @brief Validates @p sample and returns a View over it without decoding
+/// any field.
+inline std::expected<View, types::ParseError>
+view(std::string_view sample) noexcept {
+  return make_view<View>(sample);
 }
 
 inline void print(const GGA &data) {
   std::println("Type: {}", p_tools::to_string(data.type));
+  std::println("Talker: {}", p_tools::to_string(data.talker));
   std::println("UTC Time: {}", p_tools::to_string(data.utc_time));
   std::println("Latitude: {}", p_tools::to_string(data.latitude));
   std::println("Longitude: {}", p_tools::to_string(data.longitude));
@@ -5,43 +5,89 @@
 #include <print>
 
 #include "p_tools.h"
+#include "schema.h"
+#include "serialize.h"
 #include "tools.h"
 #include "types.h"
+#include "view.h"
 
 namespace cnmea::gll {
 
 struct GLL {
   types::Type type;
+  types::Talker talker;
   std::optional<types::Latitude> latitude;
   std::optional<types::Longitude> longitude;
-  types::UTCTime utc_time;
+  std::optional<types::UTCTime> utc_time;
   types::Status status;
   std::optional<types::Mode> mode;
+
+  bool operator==(const GLL &) const = default;
 };
 
-inline std::expected<GLL, types::ParseError> parse(std::string_view sample) {
-  if (!tools::is_valid_sample(sample)) {
-    return std::unexpected(types::ParseError::InvalidFormat);
-  }
+/// @brief Field layout; MIN_FIELDS and the parsers are generated from it.
+using Layout = schema::Layout<
+    GLL, types::Type::GLL,
+    schema::Field<&GLL::latitude, &tools::parse_latitude, 1, 2>,
+    schema::Field<&GLL::longitude, &tools::parse_longitude, 3, 4>,
+    schema::Field<&GLL::utc_time, &tools::parse_utc_time, 5>,
+    schema::Field<&GLL::status, &tools::parse_status, 6>,
+    schema::OptionalField<&GLL::mode, &tools::parse_mode, 7>>;
+
+/// @brief Minimum number of fields, header included.
+/// The mode indicator (NMEA 2.3+) is optional.
+constexpr std::size_t MIN_FIELDS{Layout::MIN_FIELDS};
+
+inline std::expected<GLL, types::ParseError>
+parse(const types::Header &header, const tools::Tokens &tokens) noexcept {
+  return Layout::parse(header, tokens);
+}
 
-  auto tokens = tools::tokenize(sample);
+inline std::expected<GLL, types::ParseError>
+parse(std::string_view sample) noexcept {
+  return Layout::parse(sample);
+}
 
-  if (tokens.empty()) {
-    return std::unexpected(types::ParseError::UnknownError);
+/// @brief Writes @p data into @p buffer as a complete sentence, checksum
+/// and CRLF included, without allocating.
+/// @return The sentence length, or BufferOverflow when @p buffer is too
+/// small.
+inline std::expected<std::size_t, types::ParseError>
+encode(const GLL &data, std::span<char> buffer) noexcept {
+  serialize::SentenceWriter out{buffer};
+  out.begin(data.talker, data.type);
+  out.latitude(data.latitude);
+  out.longitude(data.longitude);
+  out.time(data.utc_time);
+  out.field(data.status == types::Status::Valid ? 'A' : 'V');
+  if (data.mode) {
+    out.field(serialize::mode_code(data.mode.value()));
   }
+  return out.finish();
+}
+
+/// @brief GLL sentence decoded field by field on access; see SentenceView.
+class View : public SentenceView<Layout> {
+public:
+  using SentenceView::SentenceView;
+
+  decltype(auto) latitude() const noexcept { return get<&GLL::latitude>(); }
+  decltype(auto) longitude() const noexcept { return get<&GLL::longitude>(); }
+  decltype(auto) utc_time() const noexcept { return get<&GLL::utc_time>(); }
+  decltype(auto) status() const noexcept { return get<&GLL::status>(); }
+  decltype(auto) mode() const noexcept { return get<&GLL::mode>(); }
+};
 
-  return GLL{
-      tools::parse_type(tokens.at(0)),
-      tools::parse_latitude(tokens.at(1), tokens.at(2)),
-      tools::parse_longitude(tokens.at(3), tokens.at(4)),
-      tools::parse_utc_time(tokens.at(5)),
-      tools::parse_status(tokens.at(6)),
-      tools::parse_mode(tokens.at(7)),
-  };
+/// @brief Validates @p sample and returns a View over it without decoding
+/// any field.
+inline std::expected<View, types::ParseError>
+view(std::string_view sample) noexcept {
+  return make_view<View>(sample);
 }
 
 inline void print(const GLL &data) {
   std::println("Type: {}", p_tools::to_string(data.type));
+  std::println("Talker: {}", p_tools::to_string(data.talker));
   std::println("Latitude: {}", p_tools::to_string(data.latitude));
   std::println("Longitude: {}", p_tools::to_string(data.longitude));
   std::println("UTC Time: {}", p_tools::to_string(data.utc_time));
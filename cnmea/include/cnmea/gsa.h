@@ -1,14 +1,18 @@
 #pragma once
 
 #include <expected>
+#include <memory_resource>
 #include <optional>
 #include <print>
 #include <string_view>
 #include <vector>
 
 #include "p_tools.h"
+#include "schema.h"
+#include "serialize.h"
 #include "tools.h"
 #include "types.h"
+#include "view.h"
 
 namespace cnmea::gsa {
 
@@ -20,7 +24,8 @@ namespace cnmea::gsa {
 /// using namespace cnmea::sentences;
 ///
 /// GSA gsa_example{
-///     "GSA",
+///     Type::GSA,
+///     Talker::GN,
 ///     SelectionMode::Automatic,
 ///     FixType::ThreeD,
 ///     {Satellite{12}, Satellite{24}, Satellite{32}}, // satellites in use
@@ -32,61 +37,106 @@ namespace cnmea::gsa {
 /// }
 /// @endcode
 struct GSA {
-  types::Type type;                         ///< Sentence type ("GSA")
-  types::SelectionMode selection_mode;      ///< Manual or Automatic
-  types::FixType fix_type;                  ///< Fix type (None, 2D, 3D)
-  std::vector<types::Satellite> satellites; ///< Satellites used in solution
+  types::Type type;                    ///< Sentence type ("GSA")
+  types::Talker talker;                ///< Talker identifier (GP, GN, ...)
+  types::SelectionMode selection_mode; ///< Manual or Automatic
+  types::FixType fix_type;             ///< Fix type (None, 2D, 3D)
+  std::pmr::vector<types::Satellite> satellites; ///< Satellites in solution
   std::optional<types::DOP> dop; ///< Dilution of Precision (DOP) values
-};
-
-inline std::expected<GSA, types::ParseError> parse(std::string_view sample) {
-  if (!tools::is_valid_sample(sample)) {
-    return std::unexpected(types::ParseError::InvalidFormat);
-  }
-
-  auto tokens = tools::tokenize(sample);
 
-  if (tokens.empty()) {
-    return std::unexpected(types::ParseError::UnknownError);
-  }
+  bool operator==(const GSA &) const = default;
+};
 
-  GSA gsa;
+/// @brief Most satellites a single GSA sentence reports.
+constexpr std::size_t MAX_SATELLITES{12};
 
-  // Example: $GNGSA,A,3,02,04,05,12,13,,,,,,,,1.8,1.0,1.5*33
-  // tokens[0] = "$GNGSA"
-  // tokens[1] = Mode (A/M)
-  // tokens[2] = FixType (1=No fix, 2=2D, 3=3D)
-  // tokens[3..14] = up to 12 PRNs
-  // tokens[15] = PDOP
-  // tokens[16] = HDOP
-  // tokens[17] = VDOP
+/// @brief GSA lists only the PRNs of the satellites in use.
+inline std::optional<types::Satellite>
+parse_prn(std::string_view prn) noexcept {
+  return tools::parse_satellite(prn, {}, {}, {});
+}
 
-  gsa.type = tools::parse_type(tokens.at(0));
-  gsa.selection_mode = tools::parse_selection_mode(tokens.at(1));
-  gsa.fix_type = tools::parse_fix_type(tokens.at(2));
+/// @brief Field layout; MIN_FIELDS and the parsers are generated from it.
+/// Example: $GNGSA,A,3,02,04,05,12,13,,,,,,,,1.8,1.0,1.5*33
+using Layout = schema::Layout<
+    GSA, types::Type::GSA,
+    schema::Field<&GSA::selection_mode, &tools::parse_selection_mode, 1>,
+    schema::Field<&GSA::fix_type, &tools::parse_fix_type, 2>,
+    schema::Repeated<&GSA::satellites, &parse_prn, 3, 1, MAX_SATELLITES>,
+    schema::OptionalField<&GSA::dop, &tools::parse_dop, 15, 16, 17>>;
+
+/// @brief Minimum number of fields, header included.
+/// Satellites and DOP values are optional.
+constexpr std::size_t MIN_FIELDS{Layout::MIN_FIELDS};
+
+/// @brief Decodes a GSA sentence; the satellite list is allocated from
+/// @p resource.
+inline std::expected<GSA, types::ParseError>
+parse(const types::Header &header, const tools::Tokens &tokens,
+      std::pmr::memory_resource *resource =
+          std::pmr::get_default_resource()) noexcept {
+  return Layout::parse(header, tokens, resource);
+}
 
-  // Satellites (just PRNs in GSA, no SNR/elev/azimuth)
-  for (size_t i = 3; i <= 14 && i < tokens.size(); i++) {
-    auto sat = tools::parse_satellite(tokens.at(i), "", "",
-                                      ""); // Only PRN is available in GSA.
+inline std::expected<GSA, types::ParseError>
+parse(std::string_view sample, std::pmr::memory_resource *resource =
+                                   std::pmr::get_default_resource()) noexcept {
+  return Layout::parse(sample, resource);
+}
 
-    if (sat) {
-      gsa.satellites.push_back(sat.value());
+/// @brief Writes @p data into @p buffer as a complete sentence, checksum
+/// and CRLF included, without allocating.
+/// @return The sentence length, or BufferOverflow when @p buffer is too
+/// small.
+inline std::expected<std::size_t, types::ParseError>
+encode(const GSA &data, std::span<char> buffer) noexcept {
+  serialize::SentenceWriter out{buffer};
+  out.begin(data.talker, data.type);
+  out.field(data.selection_mode == types::SelectionMode::Manual ? 'M' : 'A');
+  out.integer(static_cast<int>(data.fix_type) + 1);
+  for (std::size_t i = 0; i < MAX_SATELLITES; i++) {
+    if (i < data.satellites.size()) {
+      out.integer(data.satellites[i].prn, 2);
+    } else {
+      out.empty();
     }
   }
+  if (data.dop) {
+    out.number(data.dop->pdop);
+    out.number(data.dop->hdop);
+    out.number(data.dop->vdop);
+  } else {
+    out.empty();
+    out.empty();
+    out.empty();
+  }
+  return out.finish();
+}
+
+/// @brief GSA sentence decoded field by field on access; see SentenceView.
+class View : public SentenceView<Layout> {
+public:
+  using SentenceView::SentenceView;
 
-  // DOP values (if present)
-  if (tokens.size() >= 18) {
-    gsa.dop = tools::parse_dop(std::string_view{tokens.at(15)},
-                               std::string_view{tokens.at(16)},
-                               std::string_view{tokens.at(17)});
+  decltype(auto) selection_mode() const noexcept {
+    return get<&GSA::selection_mode>();
   }
+  decltype(auto) fix_type() const noexcept { return get<&GSA::fix_type>(); }
+  decltype(auto) satellites() const noexcept { return get<&GSA::satellites>(); }
+  decltype(auto) dop() const noexcept { return get<&GSA::dop>(); }
+};
 
-  return gsa;
+/// @brief Validates @p sample and returns a View over it without decoding
+/// any field; the satellite list is allocated from @p resource on access.
+inline std::expected<View, types::ParseError>
+view(std::string_view sample, std::pmr::memory_resource *resource =
+                                  std::pmr::get_default_resource()) noexcept {
+  return make_view<View>(sample, resource);
 }
 
 inline void print(const GSA &data) {
   std::println("Type: {}", p_tools::to_string(data.type));
+  std::println("Talker: {}", p_tools::to_string(data.talker));
   std::println("Selection Mode: {}", p_tools::to_string(data.selection_mode));
   std::println("Fix Type: {}", p_tools::to_string(data.fix_type));
   std::println("Satellites:");
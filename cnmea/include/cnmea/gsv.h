@@ -1,59 +1,112 @@
 #pragma once
 
 #include <expected>
+#include <memory_resource>
 #include <vector>
 
+#include "decode.h"
 #include "p_tools.h"
+#include "schema.h"
+#include "serialize.h"
 #include "tools.h"
 #include "types.h"
+#include "view.h"
 
 namespace cnmea::gsv {
 
 struct GSV {
   types::Type type;       ///< Sentence type ("GSV")
+  types::Talker talker;   ///< Talker identifier (GP, GL, ...)
   int total_messages;     ///< Total number of GSV sentences for this cycle
   int message_number;     ///< Sentence number within this cycle
   int satellites_in_view; ///< Total satellites in view
-  std::vector<types::Satellite> satellites; ///< Up to 4 satellites per sentence
+  std::pmr::vector<types::Satellite> satellites; ///< Up to 4 per sentence
+
+  bool operator==(const GSV &) const = default;
 };
 
-inline std::expected<GSV, types::ParseError> parse(std::string_view sample) {
-  if (!tools::is_valid_sample(sample)) {
-    return std::unexpected(types::ParseError::InvalidFormat);
-  }
+/// @brief Most satellites a single GSV sentence reports.
+constexpr std::size_t MAX_SATELLITES{4};
+
+/// @brief Field layout; MIN_FIELDS and the parsers are generated from it.
+using Layout = schema::Layout<
+    GSV, types::Type::GSV,
+    schema::Field<&GSV::total_messages,
+                  schema::value_or<&decode::integer<int>, 0>, 1>,
+    schema::Field<&GSV::message_number,
+                  schema::value_or<&decode::integer<int>, 0>, 2>,
+    schema::Field<&GSV::satellites_in_view,
+                  schema::value_or<&decode::integer<int>, 0>, 3>,
+    schema::Repeated<&GSV::satellites, &tools::parse_satellite, 4, 4,
+                     MAX_SATELLITES>>;
+
+/// @brief Minimum number of fields, header included.
+/// Satellite blocks are optional.
+constexpr std::size_t MIN_FIELDS{Layout::MIN_FIELDS};
+
+/// @brief Decodes a GSV sentence; the satellite list is allocated from
+/// @p resource.
+inline std::expected<GSV, types::ParseError>
+parse(const types::Header &header, const tools::Tokens &tokens,
+      std::pmr::memory_resource *resource =
+          std::pmr::get_default_resource()) noexcept {
+  return Layout::parse(header, tokens, resource);
+}
 
-  auto tokens = tools::tokenize(sample);
+inline std::expected<GSV, types::ParseError>
+parse(std::string_view sample, std::pmr::memory_resource *resource =
+                                   std::pmr::get_default_resource()) noexcept {
+  return Layout::parse(sample, resource);
+}
 
-  if (tokens.empty()) {
-    return std::unexpected(types::ParseError::UnknownError);
+/// @brief Writes @p data into @p buffer as a complete sentence, checksum
+/// and CRLF included, without allocating.
+/// @return The sentence length, or BufferOverflow when @p buffer is too
+/// small.
+inline std::expected<std::size_t, types::ParseError>
+encode(const GSV &data, std::span<char> buffer) noexcept {
+  serialize::SentenceWriter out{buffer};
+  out.begin(data.talker, data.type);
+  out.integer(data.total_messages);
+  out.integer(data.message_number);
+  out.integer(data.satellites_in_view, 2);
+  for (const types::Satellite &satellite : data.satellites) {
+    out.integer(satellite.prn, 2);
+    out.measure(satellite.elevation, 2);
+    out.measure(satellite.azimuth, 3);
+    out.measure(satellite.snr, 2);
   }
+  return out.finish();
+}
+
+/// @brief GSV sentence decoded field by field on access; see SentenceView.
+class View : public SentenceView<Layout> {
+public:
+  using SentenceView::SentenceView;
 
-  GSV gsv;
-
-  gsv.type = tools::parse_type(tokens[0]);
-  gsv.total_messages =
-      static_cast<int>(tools::parse_numeric_value(tokens[1]).value_or(0));
-  gsv.message_number =
-      static_cast<int>(tools::parse_numeric_value(tokens[2]).value_or(0));
-  gsv.satellites_in_view =
-      static_cast<int>(tools::parse_numeric_value(tokens[3]).value_or(0));
-
-  // Parse satellite information (up to 4 satellites)
-  for (size_t i = 4; i < tokens.size(); i += 4) {
-    if (i + 3 < tokens.size()) {
-      auto sat = tools::parse_satellite(tokens[i], tokens[i + 1], tokens[i + 2],
-                                        tokens[i + 3]);
-      if (sat) {
-        gsv.satellites.push_back(sat.value());
-      }
-    }
+  decltype(auto) total_messages() const noexcept {
+    return get<&GSV::total_messages>();
   }
+  decltype(auto) message_number() const noexcept {
+    return get<&GSV::message_number>();
+  }
+  decltype(auto) satellites_in_view() const noexcept {
+    return get<&GSV::satellites_in_view>();
+  }
+  decltype(auto) satellites() const noexcept { return get<&GSV::satellites>(); }
+};
 
-  return gsv;
+/// @brief Validates @p sample and returns a View over it without decoding
+/// any field; the satellite list is allocated from @p resource on access.
+inline std::expected<View, types::ParseError>
+view(std::string_view sample, std::pmr::memory_resource *resource =
+                                  std::pmr::get_default_resource()) noexcept {
+  return make_view<View>(sample, resource);
 }
 
 inline void print(const GSV &data) {
   std::println("Type: {}", p_tools::to_string(data.type));
+  std::println("Talker: {}", p_tools::to_string(data.talker));
   std::println("Total Messages: {}", data.total_messages);
   std::println("Message Number: {}", data.message_number);
   std::println("Satellites in View: {}", data.satellites_in_view);
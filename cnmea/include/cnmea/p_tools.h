@@ -1,6 +1,7 @@
 #pragma once
 
 #include <format>
+#include <optional>
 #include <print>
 #include <string>
 
@@ -113,18 +114,17 @@ inline std::string to_string(const std::optional<types::Course> &course) {
 
 inline std::string to_string(const std::optional<types::UTCDate> &utc_date) {
   if (utc_date.has_value()) {
-    return std::format("{}/{}/{}", utc_date->day, utc_date->month,
+    return std::format("{:02}/{:02}/{:04}", utc_date->day, utc_date->month,
                        utc_date->year);
   }
-  return "--/--/--";
+  return "--/--/----";
 }
 
-inline std::string to_string(const types::UTCTime &utc_time) {
-  if (!(utc_time.hours.empty() || utc_time.minutes.empty() ||
-        utc_time.seconds.empty())) {
-
-    return std::format("{}:{}:{}", utc_time.hours, utc_time.minutes,
-                       utc_time.seconds);
+inline std::string to_string(const std::optional<types::UTCTime> &utc_time) {
+  if (utc_time.has_value()) {
+    return std::format("{:02}:{:02}:{:02}.{:03}", utc_time->hours,
+                       utc_time->minutes, utc_time->seconds,
+                       utc_time->nanoseconds / 1'000'000);
   }
   return "--:--:--";
 }
@@ -168,6 +168,30 @@ inline std::string to_string(const types::Type &type) {
   return "--";
 }
 
+inline std::string to_string(const types::Talker &talker) {
+  using enum types::Talker;
+  switch (talker) {
+  case GP:
+    return "GPS";
+  case GL:
+    return "GLONASS";
+  case GA:
+    return "Galileo";
+  case GB:
+    return "BeiDou";
+  case GQ:
+    return "QZSS";
+  case GI:
+    return "NavIC";
+  case GN:
+    return "GNSS";
+  case Unknown:
+    return "Unknown";
+  }
+
+  return "--";
+}
+
 inline std::string to_string(const types::ParseError &error) {
   using enum types::ParseError;
   switch (error) {
@@ -197,6 +221,22 @@ inline std::string to_string(const types::ParseError &error) {
     return "Invalid Magnetic Variation";
   case InvalidMode:
     return "Invalid Mode";
+  case TooManyFields:
+    return "Too Many Fields";
+  case InvalidChecksum:
+    return "Invalid Checksum";
+  case InvalidStatus:
+    return "Invalid Status";
+  case InvalidFixQuality:
+    return "Invalid Fix Quality";
+  case InvalidSelectionMode:
+    return "Invalid Selection Mode";
+  case InvalidFixType:
+    return "Invalid Fix Type";
+  case BufferOverflow:
+    return "Buffer Overflow";
+  case IOError:
+    return "I/O Error";
   }
   return "--";
 }
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "bulk.h"
+#include "cnmea.h"
+#include "filter.h"
+#include "types.h"
+
+/**
+ * @namespace cnmea::parallel
+ * @brief Multi-core parsing of large buffers and log files.
+ */
+namespace cnmea::parallel {
+
+/// @brief Configuration of a parallel parse.
+struct Options {
+  /// Worker threads; 0 uses every hardware thread.
+  std::size_t threads{0};
+  /// Approximate bytes per work item; chunks end on sentence boundaries.
+  std::size_t chunk_size{std::size_t{1} << 20};
+  /// Deliver results in input order. When false, results are delivered
+  /// chunk by chunk as workers finish them.
+  bool ordered{true};
+  /// Allocate each chunk's results from its own monotonic arena, released
+  /// in one step once the chunk has been delivered. Workers then never
+  /// contend on the global allocator. When false, results use the default
+  /// memory resource.
+  bool chunk_arenas{true};
+  /// Sentences to parse; the rest are dropped before validation and not
+  /// counted.
+  Filter filter{};
+};
+
+/// @brief Results of one chunk, optionally allocated from a private arena.
+class Batch {
+public:
+  Batch(std::string_view chunk, const Options &options)
+      : arena(std::max<std::size_t>(chunk.size(), 1)),
+        results(options.chunk_arenas ? &arena
+                                     : std::pmr::get_default_resource()) {
+    // Typical sentences are 40-80 bytes; reserving avoids regrowing, which
+    // a monotonic arena cannot reclaim.
+    results.reserve(chunk.size() / 64);
+    bulk::parse_buffer(chunk, options.filter, std::back_inserter(results),
+                       results.get_allocator().resource());
+  }
+
+  Batch(const Batch &) = delete;
+  Batch &operator=(const Batch &) = delete;
+
+  const std::pmr::vector<Result> &view() const noexcept { return results; }
+
+private:
+  // Declared first so it outlives the results allocated from it.
+  std::pmr::monotonic_buffer_resource arena;
+  std::pmr::vector<Result> results;
+};
+
+/// @brief Splits @p buffer into chunks of roughly @p chunk_size bytes.
+///
+/// Every chunk but the first starts at the first `$` or `!` after a newline,
+/// so no sentence straddles two chunks.
+inline std::vector<std::string_view> split_chunks(std::string_view buffer,
+                                                  std::size_t chunk_size) {
+  std::vector<std::string_view> chunks;
+  chunk_size = std::max<std::size_t>(chunk_size, 1);
+
+  while (!buffer.empty()) {
+    std::size_t end = buffer.size();
+
+    if (chunk_size < buffer.size()) {
+      std::size_t newline = buffer.find('\n', chunk_size);
+      if (newline != std::string_view::npos) {
+        end = std::min(buffer.find_first_of("$!", newline), buffer.size());
+      }
+    }
+
+    chunks.push_back(buffer.substr(0, end));
+    buffer.remove_prefix(end);
+  }
+
+  return chunks;
+}
+
+/// @brief Parses @p buffer on a pool of worker threads.
+///
+/// Workers claim chunks from a shared atomic cursor, so fast workers keep
+/// taking work while slow ones finish theirs. In ordered mode the calling
+/// thread delivers results in input order, and workers stay at most a few
+/// chunks ahead of it, which bounds memory. In unordered mode workers deliver
+/// each finished chunk themselves. The handler is never called concurrently
+/// in either mode. An exception thrown by the handler in ordered mode is
+/// rethrown once the workers have stopped; in unordered mode the handler
+/// runs on the workers and must not throw.
+///
+/// @return The number of sentences parsed.
+template <typename Handler>
+  requires std::invocable<Handler &, const Result &>
+std::size_t parse_buffer(std::string_view buffer, const Options &options,
+                         Handler &&handler) {
+  std::size_t threads = options.threads != 0
+                            ? options.threads
+                            : std::max(1u, std::thread::hardware_concurrency());
+
+  std::vector<std::string_view> chunks =
+      split_chunks(buffer, options.chunk_size);
+
+  if (threads == 1 || chunks.size() <= 1) {
+    return bulk::parse_buffer(buffer, options.filter, handler);
+  }
+
+  std::atomic<std::size_t> cursor{0};
+  std::atomic<std::size_t> total{0};
+
+  if (!options.ordered) {
+    std::mutex handler_mutex;
+    {
+      std::vector<std::jthread> workers;
+      for (std::size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&] {
+          for (std::size_t i = cursor++; i < chunks.size(); i = cursor++) {
+            Batch batch{chunks[i], options};
+            total += batch.view().size();
+
+            std::scoped_lock lock{handler_mutex};
+            for (const Result &result : batch.view()) {
+              handler(result);
+            }
+          }
+        });
+      }
+    }
+    return total;
+  }
+
+  const std::size_t window = threads * 4;
+
+  std::vector<std::unique_ptr<Batch>> batches(chunks.size());
+  auto ready = std::make_unique<std::atomic<bool>[]>(chunks.size());
+  std::atomic<std::size_t> delivered{0};
+
+  std::vector<std::jthread> workers;
+  for (std::size_t t = 0; t < threads; t++) {
+    workers.emplace_back([&] {
+      for (std::size_t i = cursor++; i < chunks.size(); i = cursor++) {
+        for (std::size_t done = delivered.load(); i >= done + window;
+             done = delivered.load()) {
+          delivered.wait(done);
+        }
+
+        batches[i] = std::make_unique<Batch>(chunks[i], options);
+        ready[i].store(true);
+        ready[i].notify_one();
+      }
+    });
+  }
+
+  // Destroyed before the workers: when the handler throws, this ends the
+  // claims and opens the window so that the workers can be joined while the
+  // exception propagates.
+  struct Release {
+    std::atomic<std::size_t> &cursor;
+    std::atomic<std::size_t> &delivered;
+    std::size_t end;
+
+    ~Release() {
+      cursor.store(end);
+      delivered.store(end);
+      delivered.notify_all();
+    }
+  } release{cursor, delivered, chunks.size()};
+
+  for (std::size_t i = 0; i < chunks.size(); i++) {
+    ready[i].wait(false);
+
+    for (const Result &result : batches[i]->view()) {
+      handler(result);
+    }
+
+    total += batches[i]->view().size();
+    batches[i].reset();
+
+    delivered.store(i + 1);
+    delivered.notify_all();
+  }
+
+  return total;
+}
+
+/// @brief Memory-maps the log at @p path and parses it in parallel.
+template <typename Handler>
+  requires std::invocable<Handler &, const Result &>
+std::expected<std::size_t, types::ParseError>
+parse_file(const std::filesystem::path &path, const Options &options,
+           Handler &&handler) {
+  auto file = bulk::map_file(path);
+
+  if (!file) {
+    return std::unexpected(file.error());
+  }
+
+  return parse_buffer(file->view(), options, handler);
+}
+
+} // namespace cnmea::parallel
@@ -0,0 +1,472 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "cnmea.h"
+#include "filter.h"
+#include "stream.h"
+#include "types.h"
+
+/**
+ * @namespace cnmea::pipeline
+ * @brief Lock-free stages connecting reader, parser and consumer threads.
+ */
+namespace cnmea::pipeline {
+
+/// @brief Assumed cache line size; std::hardware_destructive_interference_size
+/// is not ABI-stable across compiler flags.
+constexpr std::size_t CACHE_LINE{64};
+
+/// @brief What a full ring does with a new element.
+enum class Overflow {
+  Block,      ///< The producer waits for the consumer
+  DropNewest, ///< The new element is discarded
+  DropOldest  ///< The oldest unread element is discarded to make room
+};
+
+/// @brief Waits with increasing cost: spinning, then yielding, then short
+/// sleeps. For idle loops of pipeline stages.
+class Backoff {
+public:
+  void wait() noexcept {
+    if (rounds < SPINS) {
+      rounds++;
+    } else if (rounds < SPINS + YIELDS) {
+      rounds++;
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds{50});
+    }
+  }
+
+  void reset() noexcept { rounds = 0; }
+
+private:
+  static constexpr unsigned SPINS{64};
+  static constexpr unsigned YIELDS{64};
+  unsigned rounds{0};
+};
+
+/// @brief Bounded lock-free ring between exactly one producer thread and
+/// one consumer thread.
+///
+/// Every slot carries a sequence number telling whose turn it is, so the
+/// producer and the consumer never read each other's position and share a
+/// cache line only when they touch the same slot: each slot is padded to
+/// whole cache lines, at the cost of at least 64 bytes per element. Their
+/// private positions and counters live on separate cache lines. Elements
+/// are moved in and out; nothing is allocated after construction.
+///
+/// With Overflow::DropOldest the producer may take back the oldest unread
+/// slot: it and the consumer race for that slot with one compare-and-swap,
+/// and the consumer skips slots that were overwritten. The other policies
+/// never contend.
+///
+/// close() marks the end of the stream; the consumer sees done() once it
+/// has taken every element pushed before.
+template <typename T> class SpscRing {
+public:
+  /// @brief Creates a ring of at least @p capacity elements, rounded up to
+  /// a power of two.
+  explicit SpscRing(std::size_t capacity, Overflow overflow = Overflow::Block)
+      : mask(std::bit_ceil(std::max<std::size_t>(capacity, 2)) - 1),
+        slots(std::make_unique<Slot[]>(mask + 1)), overflow(overflow) {
+    for (std::size_t i = 0; i <= mask; i++) {
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  SpscRing(const SpscRing &) = delete;
+  SpscRing &operator=(const SpscRing &) = delete;
+
+  ~SpscRing() {
+    while (pop()) {
+    }
+  }
+
+  std::size_t capacity() const noexcept { return mask + 1; }
+
+  /// @brief Elements discarded by the overflow policy so far.
+  std::size_t dropped() const noexcept {
+    return producer.dropped.load(std::memory_order_relaxed);
+  }
+
+  // Producer side
+
+  /// @brief Appends @p value, applying the overflow policy when full.
+  /// @return Whether @p value was stored; false when it was dropped or
+  /// @p stop was requested while blocked.
+  bool push(T value, std::stop_token stop = {}) {
+    std::size_t position = producer.tail;
+    Slot &slot = slots[position & mask];
+    Backoff backoff;
+
+    for (;;) {
+      std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+      if (sequence == position) {
+        break;
+      }
+
+      // The slot still holds element position - capacity.
+      if (sequence == position - mask) {
+        if (overflow == Overflow::DropNewest) {
+          count_drop();
+          return false;
+        }
+        if (overflow == Overflow::DropOldest &&
+            slot.sequence.compare_exchange_strong(
+                sequence, BUSY, std::memory_order_acquire)) {
+          std::destroy_at(slot.get());
+          count_drop();
+          break;
+        }
+      }
+
+      // Full, or the consumer is reading the slot right now.
+      if (stop.stop_requested()) {
+        return false;
+      }
+      backoff.wait();
+    }
+
+    std::construct_at(slot.get(), std::move(value));
+    slot.sequence.store(position + 1, std::memory_order_release);
+    producer.tail = position + 1;
+    return true;
+  }
+
+  /// @brief Appends the elements of @p values, moving from them.
+  /// @return The number stored.
+  std::size_t push_batch(std::span<T> values, std::stop_token stop = {}) {
+    std::size_t stored = 0;
+    for (T &value : values) {
+      if (push(std::move(value), stop)) {
+        stored++;
+      } else if (stop.stop_requested()) {
+        break;
+      }
+    }
+    return stored;
+  }
+
+  /// @brief Marks the end of the stream.
+  void close() noexcept {
+    producer.closed.store(true, std::memory_order_release);
+  }
+
+  // Consumer side
+
+  /// @brief Takes the oldest element, if any.
+  std::optional<T> pop() {
+    std::optional<T> value;
+    pop_batch([&value](T &&element) { value.emplace(std::move(element)); },
+              1);
+    return value;
+  }
+
+  /// @brief Takes up to @p max elements, calling `consume(T &&)` for each.
+  /// @return The number taken.
+  template <typename Consume>
+    requires std::invocable<Consume &, T &&>
+  std::size_t pop_batch(Consume &&consume,
+                        std::size_t max =
+                            std::numeric_limits<std::size_t>::max()) {
+    std::size_t taken = 0;
+
+    while (taken < max) {
+      Slot *slot = ready();
+
+      if (slot == nullptr) {
+        break;
+      }
+
+      std::size_t position = consumer.head;
+
+      if (overflow == Overflow::DropOldest) {
+        std::size_t expected = position + 1;
+        if (!slot->sequence.compare_exchange_strong(
+                expected, BUSY, std::memory_order_acquire)) {
+          continue; // The producer dropped it; ready() skips it.
+        }
+      }
+
+      // Hand the slot back before running the callback, so a slow
+      // consumer never holds up the producer. One laundered pointer: with
+      // two, optimizing GCC 12 takes a moved variant for uninitialized.
+      T *element = slot->get();
+      T value = std::move(*element);
+      std::destroy_at(element);
+      slot->sequence.store(position + mask + 1, std::memory_order_release);
+      consumer.head = position + 1;
+      taken++;
+      consume(std::move(value));
+    }
+
+    return taken;
+  }
+
+  /// @brief Takes up to `out.size()` elements into @p out.
+  /// @return The number taken.
+  std::size_t pop_batch(std::span<T> out) {
+    std::size_t taken = 0;
+    return pop_batch(
+        [&](T &&element) { out[taken++] = std::move(element); }, out.size());
+  }
+
+  /// @brief Whether the producer has closed the ring and every element has
+  /// been taken.
+  bool done() noexcept {
+    // Read the flag first: pushes before close() are then visible.
+    return producer.closed.load(std::memory_order_acquire) &&
+           ready() == nullptr;
+  }
+
+private:
+  /// Sequence of a slot taken by one side while the other may want it.
+  static constexpr std::size_t BUSY{std::numeric_limits<std::size_t>::max()};
+
+  /// Padded to whole cache lines, so neighbouring slots never share one.
+  struct alignas(CACHE_LINE) Slot {
+    /// position: free for the producer at `position`; position + 1: holds
+    /// element `position`; BUSY: being taken.
+    std::atomic<std::size_t> sequence;
+    alignas(T) std::byte storage[sizeof(T)];
+
+    T *get() noexcept {
+      return std::launder(reinterpret_cast<T *>(storage));
+    }
+  };
+
+  struct alignas(CACHE_LINE) Producer {
+    std::size_t tail{0};
+    std::atomic<std::size_t> dropped{0};
+    std::atomic<bool> closed{false};
+  };
+
+  struct alignas(CACHE_LINE) Consumer {
+    std::size_t head{0};
+  };
+
+  const std::size_t mask;
+  const std::unique_ptr<Slot[]> slots;
+  const Overflow overflow;
+  Producer producer;
+  Consumer consumer;
+
+  /// Only the producer writes the counter, so no read-modify-write.
+  void count_drop() noexcept {
+    producer.dropped.store(
+        producer.dropped.load(std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed);
+  }
+
+  /// The slot of the element at the consumer's position, skipping elements
+  /// the producer dropped; nullptr when the ring is empty or the slot is
+  /// being overwritten.
+  Slot *ready() noexcept {
+    for (;;) {
+      std::size_t position = consumer.head;
+      Slot &slot = slots[position & mask];
+      std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+      if (sequence == position + 1) {
+        return &slot;
+      }
+      // BUSY: the producer may be writing the very element at `position`
+      // rather than dropping an older one, so wait for its sequence.
+      if (sequence <= position || sequence == BUSY) {
+        return nullptr;
+      }
+      // Overwritten by a later lap.
+      consumer.head = position + 1;
+    }
+  }
+};
+
+/// @brief Pins the calling thread to @p core.
+/// @return Whether the affinity was applied.
+inline bool pin_to_core(unsigned core) noexcept {
+  if (core >= CPU_SETSIZE) {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(core, &set);
+  return ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) == 0;
+}
+
+/// @brief Starts `stage(std::stop_token)` on a new thread, pinned to
+/// @p core when given.
+template <typename Stage>
+  requires std::invocable<Stage &, std::stop_token>
+std::jthread spawn(std::optional<unsigned> core, Stage stage) {
+  return std::jthread{
+      [core, stage = std::move(stage)](std::stop_token stop) mutable {
+        if (core) {
+          pin_to_core(core.value());
+        }
+        stage(stop);
+      }};
+}
+
+/// @brief Raw bytes as read from a source, passed between stages by value.
+struct Chunk {
+  static constexpr std::size_t CAPACITY{4096 - 2 * sizeof(std::uint32_t)};
+
+  std::array<char, CAPACITY> bytes;
+  std::uint32_t size{0};
+  /// Number of the chunk in its stream; a jump means chunks were dropped.
+  std::uint32_t sequence{0};
+
+  std::string_view view() const noexcept { return {bytes.data(), size}; }
+};
+
+/// @brief Reader stage: reads @p fd into @p out until end of file, an error
+/// or @p stop, then closes @p out.
+///
+/// Chunks are numbered, so that parse_stage() drops a sentence split by a
+/// chunk that @p out discarded instead of splicing its ends together. Still,
+/// every dropped chunk loses the sentences inside it: give the byte ring
+/// Overflow::Block and apply drop policies to the Sample ring, where they
+/// discard whole sentences.
+/// @return The number of bytes read.
+inline std::size_t read_stage(int fd, SpscRing<Chunk> &out,
+                              std::stop_token stop) {
+  std::size_t total = 0;
+  std::uint32_t sequence = 0;
+  pollfd readable{fd, POLLIN, 0};
+
+  while (!stop.stop_requested()) {
+    // Wake up now and then to notice a stop request.
+    if (int ready = ::poll(&readable, 1, 100);
+        ready == 0 || (ready < 0 && errno == EINTR)) {
+      continue;
+    }
+
+    Chunk chunk;
+    ssize_t n = ::read(fd, chunk.bytes.data(), Chunk::CAPACITY);
+
+    if (n < 0 && (errno == EINTR || errno == EAGAIN)) {
+      continue;
+    }
+    if (n <= 0) {
+      break;
+    }
+
+    chunk.size = static_cast<std::uint32_t>(n);
+    chunk.sequence = sequence++;
+    total += chunk.size;
+
+    // False when the policy dropped it; parse_stage() notices the gap.
+    if (!out.push(std::move(chunk), stop) && stop.stop_requested()) {
+      break;
+    }
+  }
+
+  // An empty chunk numbered after the last, so that a gap at the very end
+  // is noticed too; retried because it must not be dropped itself.
+  Chunk last;
+  last.sequence = sequence;
+  for (Backoff backoff; !out.push(last, stop) && !stop.stop_requested();) {
+    backoff.wait();
+  }
+
+  out.close();
+  return total;
+}
+
+/// @brief Parser stage: frames and parses the chunks of @p in with a
+/// StreamParser and pushes each sample to @p out, until @p in is done or
+/// @p stop, then closes @p out. After a gap in the chunk numbers the
+/// partial sentence is dropped.
+/// @return The number of sentences that failed to parse.
+inline std::size_t parse_stage(SpscRing<Chunk> &in, SpscRing<Sample> &out,
+                               std::stop_token stop, Filter filter = {}) {
+  StreamParser parser{std::move(filter)};
+  std::size_t errors = 0;
+  auto forward = [&](const Result &result) {
+    if (result) {
+      out.push(result.value(), stop);
+    } else {
+      errors++;
+    }
+  };
+
+  std::uint32_t next = 0;
+  auto feed = [&](Chunk &&chunk) {
+    if (chunk.sequence != next) {
+      parser.reset();
+    }
+    next = chunk.sequence + 1;
+    parser.feed(chunk.view(), forward);
+  };
+
+  Backoff backoff;
+  while (!stop.stop_requested()) {
+    std::size_t taken = in.pop_batch(feed);
+
+    if (taken > 0) {
+      backoff.reset();
+    } else if (in.done()) {
+      parser.flush(forward);
+      break;
+    } else {
+      backoff.wait();
+    }
+  }
+
+  out.close();
+  return errors;
+}
+
+/// @brief Consumer stage: calls `handler(T &&)` for every element of @p in
+/// until it is done or @p stop.
+/// @return The number of elements consumed.
+template <typename T, typename Handler>
+  requires std::invocable<Handler &, T &&>
+std::size_t consume_stage(SpscRing<T> &in, Handler &&handler,
+                          std::stop_token stop) {
+  std::size_t total = 0;
+  Backoff backoff;
+
+  while (!stop.stop_requested()) {
+    std::size_t taken = in.pop_batch(handler);
+
+    if (taken > 0) {
+      total += taken;
+      backoff.reset();
+    } else if (in.done()) {
+      break;
+    } else {
+      backoff.wait();
+    }
+  }
+
+  return total;
+}
+
+} // namespace cnmea::pipeline
@@ -0,0 +1,423 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "cnmea.h"
+#include "filter.h"
+#include "stream.h"
+#include "types.h"
+
+namespace cnmea {
+
+/// @brief Caller-chosen identifier of a source, e.g. a device index.
+using SourceId = std::uint32_t;
+
+/// @brief Counters of one source.
+struct SourceStats {
+  std::size_t bytes{0};     ///< Bytes read
+  std::size_t sentences{0}; ///< Results delivered, errors included
+  std::size_t errors{0};    ///< Results that were a ParseError
+};
+
+/// @brief Reads many non-blocking sources on one thread with epoll.
+///
+/// Each source is a file descriptor (tty, pipe, socket) owned by the
+/// reactor, with its own StreamParser holding the framing state between
+/// reads. poll() waits for readable sources, reads at most READ_SIZE bytes
+/// from each, so that one busy source cannot starve the rest, and calls
+/// `handler(SourceId, const Result &)` for every sentence. A source is
+/// closed at end of file or on a read error: its partial sentence is
+/// flushed and, when the handler is also invocable as `handler(SourceId)`,
+/// it is told that the source has gone.
+///
+/// Results are allocated from an arena that is released after every read;
+/// copy what must outlive the handler call. Reads whose satellite lists fit
+/// in its ARENA_SIZE initial buffer, which covers ordinary receiver traffic,
+/// do not allocate. A read dense with GSA/GSV sentences can outgrow it; the
+/// extra blocks come from the default resource and are freed again with the
+/// arena.
+///
+/// add(), size(), stats() and wake() may be called from any thread.
+/// Everything else belongs to the thread that polls; see ReactorPool for
+/// several threads.
+///
+/// Example:
+/// @code
+/// auto reactor = cnmea::Reactor::create();
+/// for (cnmea::SourceId id = 0; id < ports.size(); id++) {
+///   reactor->add(::open(ports[id], O_RDONLY | O_NOCTTY), id);
+/// }
+///
+/// reactor->run(
+///     [](cnmea::SourceId id, const cnmea::Result &result) {
+///       if (result) {
+///         store(id, result.value());
+///       }
+///     },
+///     stop_token);
+/// @endcode
+class Reactor {
+public:
+  /// @brief Bytes read from a source per readiness notification.
+  static constexpr std::size_t READ_SIZE{16 * 1024};
+  /// @brief Readiness notifications handled per poll().
+  static constexpr int MAX_EVENTS{256};
+  /// @brief Bytes the arena holds before allocating: the satellite lists of
+  /// about 40 GSA or 120 GSV sentences.
+  static constexpr std::size_t ARENA_SIZE{16 * 1024};
+
+  /// @brief Creates a reactor with an empty epoll set.
+  static std::expected<Reactor, types::ParseError> create() {
+    auto state = std::make_unique<State>();
+    state->epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    state->wakeup = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+
+    if (state->epoll < 0 || state->wakeup < 0 ||
+        ::epoll_ctl(state->epoll, EPOLL_CTL_ADD, state->wakeup, &event) != 0) {
+      return std::unexpected(types::ParseError::IOError);
+    }
+
+    return Reactor{std::move(state)};
+  }
+
+  /// @brief Adds @p fd as source @p id, switching it to non-blocking mode.
+  /// On success the reactor owns @p fd and closes it with the source.
+  /// Thread-safe.
+  /// @return IOError when @p fd cannot be polled, InvalidFormat when @p id
+  /// is already in use.
+  std::expected<void, types::ParseError> add(int fd, SourceId id,
+                                             Filter filter = {}) {
+    auto source =
+        std::make_unique<Source>(id, fd, std::move(filter), &state->arena);
+
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.ptr = source.get();
+
+    std::scoped_lock lock{state->mutex};
+
+    if (state->sources.contains(id)) {
+      return std::unexpected(types::ParseError::InvalidFormat);
+    }
+
+    int flags = ::fcntl(fd, F_GETFL);
+
+    if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0 ||
+        ::epoll_ctl(state->epoll, EPOLL_CTL_ADD, fd, &event) != 0) {
+      return std::unexpected(types::ParseError::IOError);
+    }
+
+    state->sources.emplace(id, std::move(source));
+    return {};
+  }
+
+  /// @brief Closes source @p id without flushing it.
+  /// @return Whether the source existed.
+  bool remove(SourceId id) {
+    std::unique_ptr<Source> source;
+    {
+      std::scoped_lock lock{state->mutex};
+      auto it = state->sources.find(id);
+      if (it == state->sources.end()) {
+        return false;
+      }
+      source = std::move(it->second);
+      state->sources.erase(it);
+    }
+    retire(std::move(source));
+    return true;
+  }
+
+  /// @brief Number of open sources.
+  std::size_t size() const {
+    std::scoped_lock lock{state->mutex};
+    return state->sources.size();
+  }
+
+  /// @brief Counters of source @p id, or nullopt once it is closed.
+  /// Thread-safe; while the source is being read they may lag by one read.
+  std::optional<SourceStats> stats(SourceId id) const {
+    std::scoped_lock lock{state->mutex};
+    auto it = state->sources.find(id);
+    if (it == state->sources.end()) {
+      return std::nullopt;
+    }
+    const Source &source = *it->second;
+    return SourceStats{source.bytes.load(std::memory_order_relaxed),
+                       source.sentences.load(std::memory_order_relaxed),
+                       source.errors.load(std::memory_order_relaxed)};
+  }
+
+  /// @brief Interrupts a poll() that is waiting. Thread-safe.
+  void wake() noexcept {
+    std::uint64_t one = 1;
+    [[maybe_unused]] auto written = ::write(state->wakeup, &one, sizeof(one));
+  }
+
+  /// @brief Waits up to @p timeout_ms (-1: indefinitely) for readable
+  /// sources and dispatches their sentences.
+  /// @return The number of readiness notifications handled.
+  template <typename Handler>
+    requires std::invocable<Handler &, SourceId, const Result &>
+  std::expected<std::size_t, types::ParseError> poll(Handler &&handler,
+                                                     int timeout_ms = -1) {
+    std::array<epoll_event, MAX_EVENTS> events;
+    int count =
+        ::epoll_wait(state->epoll, events.data(), MAX_EVENTS, timeout_ms);
+
+    if (count < 0) {
+      if (errno == EINTR) {
+        return 0;
+      }
+      return std::unexpected(types::ParseError::IOError);
+    }
+
+    for (int i = 0; i < count; i++) {
+      auto *source = static_cast<Source *>(events[i].data.ptr);
+
+      if (source == nullptr) {
+        std::uint64_t value;
+        [[maybe_unused]] auto n = ::read(state->wakeup, &value, sizeof(value));
+        continue;
+      }
+
+      // Closed by the handler earlier in this batch.
+      if (source->fd >= 0) {
+        read(*source, handler);
+      }
+    }
+
+    // Sources closed in this batch may still have had events in it.
+    state->retired.clear();
+    return static_cast<std::size_t>(count);
+  }
+
+  /// @brief Polls until @p stop is requested.
+  template <typename Handler>
+    requires std::invocable<Handler &, SourceId, const Result &>
+  std::expected<void, types::ParseError> run(Handler &&handler,
+                                             std::stop_token stop) {
+    std::stop_callback interrupt{stop, [this] { wake(); }};
+
+    while (!stop.stop_requested()) {
+      if (auto result = poll(handler); !result) {
+        return std::unexpected(result.error());
+      }
+    }
+    return {};
+  }
+
+private:
+  struct Source {
+    SourceId id;
+    int fd;
+    StreamParser parser;
+    // SourceStats, written by the polling thread only and read by stats().
+    std::atomic<std::size_t> bytes{0};
+    std::atomic<std::size_t> sentences{0};
+    std::atomic<std::size_t> errors{0};
+
+    Source(SourceId id, int fd, Filter filter,
+           std::pmr::memory_resource *resource)
+        : id(id), fd(fd), parser(std::move(filter), resource) {}
+  };
+
+  /// Kept behind a pointer so that sources and the arena have stable
+  /// addresses and the reactor can be moved.
+  struct State {
+    int epoll{-1};
+    int wakeup{-1};
+    mutable std::mutex mutex;
+    std::unordered_map<SourceId, std::unique_ptr<Source>> sources;
+    std::vector<std::unique_ptr<Source>> retired;
+    std::array<char, READ_SIZE> buffer;
+    std::array<std::byte, ARENA_SIZE> initial;
+    std::pmr::monotonic_buffer_resource arena{initial.data(), initial.size()};
+
+    ~State() {
+      for (auto &[id, source] : sources) {
+        ::close(source->fd);
+      }
+      if (wakeup >= 0) {
+        ::close(wakeup);
+      }
+      if (epoll >= 0) {
+        ::close(epoll);
+      }
+    }
+  };
+
+  std::unique_ptr<State> state;
+
+  explicit Reactor(std::unique_ptr<State> state) : state(std::move(state)) {}
+
+  template <typename Handler> void read(Source &source, Handler &handler) {
+    auto deliver = [&](const Result &result) {
+      count(source.sentences);
+      if (!result) {
+        count(source.errors);
+      }
+      handler(source.id, result);
+    };
+
+    ssize_t n = ::read(source.fd, state->buffer.data(), READ_SIZE);
+
+    if (n > 0) {
+      count(source.bytes, static_cast<std::size_t>(n));
+      source.parser.feed({state->buffer.data(), static_cast<std::size_t>(n)},
+                         deliver);
+      state->arena.release();
+      return;
+    }
+
+    if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+      return;
+    }
+
+    // End of file or a read error.
+    source.parser.flush(deliver);
+    state->arena.release();
+
+    SourceId id = source.id;
+    remove(id);
+    if constexpr (std::invocable<Handler &, SourceId>) {
+      handler(id);
+    }
+  }
+
+  /// Only the polling thread writes the counters, so no read-modify-write.
+  static void count(std::atomic<std::size_t> &counter,
+                    std::size_t amount = 1) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + amount,
+                  std::memory_order_relaxed);
+  }
+
+  /// Closes the descriptor now; the Source lives until the end of poll().
+  void retire(std::unique_ptr<Source> source) {
+    ::epoll_ctl(state->epoll, EPOLL_CTL_DEL, source->fd, nullptr);
+    ::close(source->fd);
+    source->fd = -1;
+    state->retired.push_back(std::move(source));
+  }
+};
+
+/// @brief Reactors on a fixed set of threads, sources sharded by ID.
+///
+/// Source `id` is polled by thread `id % threads`, so each source's
+/// sentences arrive in order on one thread while the handler as a whole is
+/// called concurrently from every thread.
+///
+/// Example:
+/// @code
+/// auto pool = cnmea::ReactorPool::create(4);
+/// pool->start(handler);
+/// for (auto [id, fd] : feeds) {
+///   pool->add(fd, id);
+/// }
+/// @endcode
+class ReactorPool {
+public:
+  /// @brief Creates @p threads reactors; 0 uses every hardware thread.
+  static std::expected<ReactorPool, types::ParseError>
+  create(std::size_t threads = 0) {
+    if (threads == 0) {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    ReactorPool pool;
+    for (std::size_t i = 0; i < threads; i++) {
+      auto reactor = Reactor::create();
+      if (!reactor) {
+        return std::unexpected(reactor.error());
+      }
+      pool.reactors.push_back(std::move(reactor.value()));
+    }
+    return pool;
+  }
+
+  ReactorPool(ReactorPool &&) = default;
+
+  /// Stops this pool's threads first: they still poll its reactors.
+  ReactorPool &operator=(ReactorPool &&other) noexcept {
+    if (this != &other) {
+      stop();
+      reactors = std::move(other.reactors);
+      workers = std::move(other.workers);
+    }
+    return *this;
+  }
+
+  ~ReactorPool() { stop(); }
+
+  /// @brief Adds @p fd as source @p id; see Reactor::add(). Thread-safe.
+  std::expected<void, types::ParseError> add(int fd, SourceId id,
+                                             Filter filter = {}) {
+    return reactors[id % reactors.size()].add(fd, id, std::move(filter));
+  }
+
+  /// @brief Starts polling on every thread. @p handler must outlive the
+  /// pool or the next stop().
+  template <typename Handler>
+    requires std::invocable<Handler &, SourceId, const Result &>
+  void start(Handler &handler) {
+    for (Reactor &reactor : reactors) {
+      workers.emplace_back([&reactor, &handler](std::stop_token stop) {
+        [[maybe_unused]] auto result = reactor.run(handler, stop);
+      });
+    }
+  }
+
+  /// @brief Stops and joins every thread; sources stay open.
+  void stop() {
+    for (std::jthread &worker : workers) {
+      worker.request_stop();
+    }
+    workers.clear();
+  }
+
+  std::size_t threads() const noexcept { return reactors.size(); }
+
+  /// @brief Total number of open sources.
+  std::size_t size() const {
+    std::size_t total = 0;
+    for (const Reactor &reactor : reactors) {
+      total += reactor.size();
+    }
+    return total;
+  }
+
+private:
+  // Declared first so that the workers are joined before the reactors go.
+  std::vector<Reactor> reactors;
+  std::vector<std::jthread> workers;
+
+  ReactorPool() = default;
+};
+
+} // namespace cnmea
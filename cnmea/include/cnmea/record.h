@@ -0,0 +1,839 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "bulk.h"
+#include "cnmea.h"
+#include "types.h"
+
+/**
+ * @namespace cnmea::record
+ * @brief Compact binary storage of parsed sentences.
+ *
+ * A record file is a 64-byte FileHeader followed by 64-byte, 64-byte aligned
+ * Records, one per sentence. Optional fields are flagged in a presence
+ * bitmap instead of std::optional, so every record is trivially copyable and
+ * a mapped file can be read in place: Reader exposes the records as a span
+ * over the page cache without copying or decoding anything.
+ *
+ * Coordinates are stored as signed decimal degrees in double precision;
+ * other measurements in single precision, in the units they were parsed
+ * with, and satellite angles and SNR in tenths. A decoded measurement thus
+ * equals the parsed one to about seven significant digits. Multi-byte
+ * values use the byte order of the writing host, which the header records;
+ * a reader on a host of the other order rejects the file.
+ *
+ * Example:
+ * @code
+ * auto reader = cnmea::record::Reader::open("drive.cnr");
+ * for (const cnmea::record::Record &record : reader->records()) {
+ *   if (record.type() == cnmea::types::Type::GGA &&
+ *       record.has(cnmea::record::GGAData::LATITUDE)) {
+ *     plot(record.gga.latitude, record.gga.longitude);
+ *   }
+ * }
+ * @endcode
+ */
+namespace cnmea::record {
+
+/// @brief Identifies a record file.
+constexpr std::array<char, 8> MAGIC{'C', 'N', 'M', 'E', 'A', 'R', 'E', 'C'};
+
+/// @brief Format version, bumped on any layout change.
+constexpr std::uint32_t VERSION{2};
+
+/// @brief Written as-is; reads back differently on a host of the other
+/// byte order.
+constexpr std::uint32_t ENDIAN_MARK{0x01020304};
+
+/// @brief First 64 bytes of a record file.
+struct alignas(64) FileHeader {
+  std::array<char, 8> magic{MAGIC};
+  std::uint32_t version{VERSION};
+  std::uint32_t endian_mark{ENDIAN_MARK};
+  std::uint32_t header_size{64};
+  std::uint32_t record_size{64};
+  /// Zero, so that the header has no padding and files are reproducible.
+  std::array<char, 40> reserved{};
+};
+
+/// @brief Marks a missing satellite angle or SNR.
+constexpr std::int16_t MISSING_TENTHS{
+    std::numeric_limits<std::int16_t>::min()};
+
+struct GGAData {
+  static constexpr std::uint16_t LATITUDE{1 << 0};
+  static constexpr std::uint16_t LONGITUDE{1 << 1};
+  static constexpr std::uint16_t ALTITUDE{1 << 2};
+  static constexpr std::uint16_t GEOID_SEPARATION{1 << 3};
+  static constexpr std::uint16_t AGE_OF_DGPS{1 << 4};
+  static constexpr std::uint16_t DGPS_STATION_ID{1 << 5};
+
+  double latitude;             ///< Signed decimal degrees
+  double longitude;            ///< Signed decimal degrees
+  float altitude;              ///< In `altitude_units`
+  float geoid_separation;      ///< In `geoid_units`
+  float hdop;                  ///< Horizontal dilution of precision
+  float age_of_dgps;           ///< Seconds
+  std::uint16_t dgps_station_id;
+  std::uint8_t fix_quality;    ///< types::FixQuality
+  std::uint8_t satellites;     ///< Satellites used
+  std::uint8_t altitude_units; ///< types::DistanceUnits
+  std::uint8_t geoid_units;    ///< types::DistanceUnits
+};
+
+struct GLLData {
+  static constexpr std::uint16_t LATITUDE{1 << 0};
+  static constexpr std::uint16_t LONGITUDE{1 << 1};
+  static constexpr std::uint16_t MODE{1 << 2};
+
+  double latitude;     ///< Signed decimal degrees
+  double longitude;    ///< Signed decimal degrees
+  std::uint8_t status; ///< types::Status
+  std::uint8_t mode;   ///< types::Mode
+};
+
+struct GSAData {
+  static constexpr std::uint16_t DOP{1 << 0};
+
+  std::uint8_t selection_mode; ///< types::SelectionMode
+  std::uint8_t fix_type;       ///< types::FixType
+  std::uint8_t count;          ///< PRNs stored in `prns`
+  std::uint8_t reserved;
+  std::array<std::uint16_t, 12> prns;
+  float pdop;
+  float hdop;
+  float vdop;
+};
+
+struct GSVData {
+  struct Satellite {
+    std::uint16_t prn;
+    std::int16_t elevation; ///< Tenths of a degree, or MISSING_TENTHS
+    std::int16_t azimuth;   ///< Tenths of a degree, or MISSING_TENTHS
+    std::int16_t snr;       ///< Tenths of a dBHz, or MISSING_TENTHS
+  };
+
+  std::uint8_t total_messages;
+  std::uint8_t message_number;
+  std::uint8_t satellites_in_view;
+  std::uint8_t count; ///< Satellites stored in `satellites`
+  std::array<Satellite, 4> satellites;
+};
+
+struct RMCData {
+  static constexpr std::uint16_t LATITUDE{1 << 0};
+  static constexpr std::uint16_t LONGITUDE{1 << 1};
+  static constexpr std::uint16_t SPEED{1 << 2};
+  static constexpr std::uint16_t COURSE{1 << 3};
+  static constexpr std::uint16_t DATE{1 << 4};
+  static constexpr std::uint16_t MAGNETIC_VARIATION{1 << 5};
+  static constexpr std::uint16_t MODE{1 << 6};
+
+  double latitude;          ///< Signed decimal degrees
+  double longitude;         ///< Signed decimal degrees
+  float speed;              ///< Knots
+  float course;             ///< Degrees
+  float magnetic_variation; ///< Signed degrees, east positive
+  std::uint16_t year;
+  std::uint8_t month;
+  std::uint8_t day;
+  std::uint8_t status; ///< types::Status
+  std::uint8_t mode;   ///< types::Mode
+};
+
+struct VTGData {
+  static constexpr std::uint16_t COURSE_TRUE{1 << 0};
+  static constexpr std::uint16_t COURSE_MAGNETIC{1 << 1};
+  static constexpr std::uint16_t SPEED_KNOTS{1 << 2};
+  static constexpr std::uint16_t SPEED_KMH{1 << 3};
+  static constexpr std::uint16_t MODE{1 << 4};
+
+  float course_true;     ///< Degrees
+  float course_magnetic; ///< Degrees
+  float speed_knots;
+  float speed_kmh;
+  std::uint8_t mode; ///< types::Mode
+};
+
+struct ZDAData {
+  static constexpr std::uint16_t LOCAL_ZONE_HOURS{1 << 0};
+  static constexpr std::uint16_t LOCAL_ZONE_MINUTES{1 << 1};
+
+  std::uint16_t year;
+  std::uint8_t month;
+  std::uint8_t day;
+  std::int8_t local_zone_hours;
+  std::int8_t local_zone_minutes;
+};
+
+namespace detail {
+
+template <typename T> constexpr std::uint8_t raw(T value) noexcept {
+  return static_cast<std::uint8_t>(value);
+}
+
+/// @brief @p byte as an enumerator of @p E no greater than @p last, or
+/// @p error.
+template <typename E>
+constexpr std::expected<E, types::ParseError>
+enumerator(std::uint8_t byte, E last, types::ParseError error) noexcept {
+  if (byte > raw(last)) {
+    return std::unexpected(error);
+  }
+  return static_cast<E>(byte);
+}
+
+} // namespace detail
+
+/// @brief One parsed sentence. type() selects the active payload member.
+///
+/// A record read from a file may be corrupt, so the enumeration accessors
+/// range-check their bytes; decode() checks the payload's as well.
+struct alignas(64) Record {
+  /// Presence bit shared by every type: the UTC time fields are set.
+  static constexpr std::uint16_t TIME{1 << 15};
+
+  std::uint8_t type_id;   ///< types::Type
+  std::uint8_t talker_id; ///< types::Talker
+  std::uint16_t presence; ///< TIME plus the bits of the payload type
+  std::uint8_t hours;
+  std::uint8_t minutes;
+  std::uint8_t seconds;
+  std::uint8_t reserved;
+  std::uint32_t nanoseconds;
+
+  union {
+    GGAData gga;
+    GLLData gll;
+    GSAData gsa;
+    GSVData gsv;
+    RMCData rmc;
+    VTGData vtg;
+    ZDAData zda;
+  };
+
+  /// @brief The sentence type, or UnsupportedType for an unknown byte.
+  std::expected<types::Type, types::ParseError> type() const noexcept {
+    return detail::enumerator(type_id, types::Type::ZDA,
+                              types::ParseError::UnsupportedType);
+  }
+
+  /// @brief The talker, or InvalidFormat for an unknown byte.
+  std::expected<types::Talker, types::ParseError> talker() const noexcept {
+    return detail::enumerator(talker_id, types::Talker::Unknown,
+                              types::ParseError::InvalidFormat);
+  }
+
+  /// @brief Whether every field flagged in @p bits is present.
+  bool has(std::uint16_t bits) const noexcept {
+    return (presence & bits) == bits;
+  }
+
+  /// @brief The UTC time, if the sentence carried one.
+  std::optional<types::UTCTime> utc_time() const noexcept {
+    if (!has(TIME)) {
+      return std::nullopt;
+    }
+    return types::UTCTime{hours, minutes, seconds, nanoseconds};
+  }
+};
+
+static_assert(sizeof(FileHeader) == 64);
+static_assert(std::has_unique_object_representations_v<FileHeader>);
+static_assert(sizeof(Record) == 64);
+static_assert(std::is_trivially_copyable_v<Record>);
+
+namespace detail {
+
+inline std::int16_t tenths(double value) noexcept {
+  if (std::isnan(value)) {
+    return MISSING_TENTHS;
+  }
+  return static_cast<std::int16_t>(std::lround(value * 10.0));
+}
+
+inline double from_tenths(std::int16_t value) noexcept {
+  if (value == MISSING_TENTHS) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  return value / 10.0;
+}
+
+/// Sets @p bit and returns @p value when @p optional holds one.
+template <typename T, typename Project>
+auto present(const std::optional<T> &optional, std::uint16_t &presence,
+             std::uint16_t bit, Project project) noexcept {
+  using Value = decltype(project(optional.value()));
+  if (!optional) {
+    return Value{};
+  }
+  presence |= bit;
+  return project(optional.value());
+}
+
+inline types::Latitude latitude(double degrees) noexcept {
+  return {std::fabs(degrees), std::signbit(degrees) ? types::Direction::South
+                                                    : types::Direction::North};
+}
+
+inline types::Longitude longitude(double degrees) noexcept {
+  return {std::fabs(degrees), std::signbit(degrees) ? types::Direction::West
+                                                    : types::Direction::East};
+}
+
+inline types::MagneticVariation magnetic_variation(double degrees) noexcept {
+  return {std::fabs(degrees), std::signbit(degrees) ? types::Direction::West
+                                                    : types::Direction::East};
+}
+
+/// Checks every enumeration byte of @p record, with the error the text
+/// parser reports for the same field, so that decode() may cast them.
+/// @return The record's type.
+inline std::expected<types::Type, types::ParseError>
+validate(const Record &record) noexcept {
+  using types::ParseError;
+  auto type = record.type();
+  auto talker = record.talker();
+
+  if (!type) {
+    return type;
+  }
+  if (!talker) {
+    return std::unexpected(talker.error());
+  }
+
+  std::optional<ParseError> error;
+  auto check = [&](bool present, std::uint8_t byte, auto last,
+                   ParseError invalid) {
+    if (present && !error && byte > raw(last)) {
+      error = invalid;
+    }
+  };
+  auto status = [&](std::uint8_t byte) {
+    check(true, byte, types::Status::Invalid, ParseError::InvalidStatus);
+  };
+  auto mode = [&](std::uint16_t bit, std::uint8_t byte) {
+    check(record.has(bit), byte, types::Mode::Uncalibrated,
+          ParseError::InvalidMode);
+  };
+  auto units = [&](std::uint16_t bit, std::uint8_t byte) {
+    check(record.has(bit), byte, types::DistanceUnits::ft,
+          ParseError::UnsupportedType);
+  };
+
+  switch (type.value()) {
+  case types::Type::GGA:
+    check(true, record.gga.fix_quality, types::FixQuality::Simulation,
+          ParseError::InvalidFixQuality);
+    units(GGAData::ALTITUDE, record.gga.altitude_units);
+    units(GGAData::GEOID_SEPARATION, record.gga.geoid_units);
+    break;
+  case types::Type::GLL:
+    status(record.gll.status);
+    mode(GLLData::MODE, record.gll.mode);
+    break;
+  case types::Type::GSA:
+    check(true, record.gsa.selection_mode, types::SelectionMode::Automatic,
+          ParseError::InvalidSelectionMode);
+    check(true, record.gsa.fix_type, types::FixType::ThreeD,
+          ParseError::InvalidFixType);
+    break;
+  case types::Type::RMC:
+    status(record.rmc.status);
+    mode(RMCData::MODE, record.rmc.mode);
+    break;
+  case types::Type::VTG:
+    mode(VTGData::MODE, record.vtg.mode);
+    break;
+  case types::Type::GSV:
+  case types::Type::ZDA:
+    break;
+  }
+
+  if (error) {
+    return std::unexpected(error.value());
+  }
+  return type;
+}
+
+} // namespace detail
+
+/// @brief Encodes one decoded sentence.
+template <typename T>
+  requires std::is_constructible_v<Sample, const T &>
+Record encode(const T &data) noexcept {
+  // Zeroed as a whole so that padding and unused payload bytes are
+  // deterministic on disk.
+  Record record;
+  std::memset(&record, 0, sizeof(record));
+  record.type_id = detail::raw(data.type);
+  record.talker_id = detail::raw(data.talker);
+
+  if constexpr (requires { data.utc_time; }) {
+    if (data.utc_time) {
+      record.presence |= Record::TIME;
+      record.hours = data.utc_time->hours;
+      record.minutes = data.utc_time->minutes;
+      record.seconds = data.utc_time->seconds;
+      record.nanoseconds = data.utc_time->nanoseconds;
+    }
+  }
+
+  std::uint16_t &presence = record.presence;
+  auto degrees = [](const auto &value) { return value.value_degrees(); };
+  auto single = [](double value) { return static_cast<float>(value); };
+
+  if constexpr (std::is_same_v<T, GGA>) {
+    GGAData &out = record.gga;
+    out.latitude =
+        detail::present(data.latitude, presence, GGAData::LATITUDE, degrees);
+    out.longitude =
+        detail::present(data.longitude, presence, GGAData::LONGITUDE, degrees);
+    out.altitude = detail::present(
+        data.altitude, presence, GGAData::ALTITUDE,
+        [&](const auto &value) { return single(value.get_value()); });
+    out.altitude_units = detail::present(
+        data.altitude, presence, GGAData::ALTITUDE,
+        [](const auto &value) { return detail::raw(value.get_units()); });
+    out.geoid_separation = detail::present(
+        data.geoid_separation, presence, GGAData::GEOID_SEPARATION,
+        [&](const auto &value) { return single(value.get_value()); });
+    out.geoid_units = detail::present(
+        data.geoid_separation, presence, GGAData::GEOID_SEPARATION,
+        [](const auto &value) { return detail::raw(value.get_units()); });
+    out.age_of_dgps = detail::present(
+        data.age_of_dgps, presence, GGAData::AGE_OF_DGPS,
+        [&](const auto &value) { return single(value.value_seconds()); });
+    out.dgps_station_id = detail::present(
+        data.dgps_station_id, presence, GGAData::DGPS_STATION_ID,
+        [](const auto &value) {
+          return static_cast<std::uint16_t>(value.value());
+        });
+    out.hdop = single(data.hdop);
+    out.fix_quality = detail::raw(data.fix_quality);
+    out.satellites = static_cast<std::uint8_t>(data.num_satellites);
+  } else if constexpr (std::is_same_v<T, GLL>) {
+    GLLData &out = record.gll;
+    out.latitude =
+        detail::present(data.latitude, presence, GLLData::LATITUDE, degrees);
+    out.longitude =
+        detail::present(data.longitude, presence, GLLData::LONGITUDE, degrees);
+    out.status = detail::raw(data.status);
+    out.mode = detail::present(data.mode, presence, GLLData::MODE,
+                               detail::raw<types::Mode>);
+  } else if constexpr (std::is_same_v<T, GSA>) {
+    GSAData &out = record.gsa;
+    out.selection_mode = detail::raw(data.selection_mode);
+    out.fix_type = detail::raw(data.fix_type);
+    for (const types::Satellite &satellite : data.satellites) {
+      if (out.count < out.prns.size()) {
+        out.prns[out.count++] = static_cast<std::uint16_t>(satellite.prn);
+      }
+    }
+    if (data.dop) {
+      presence |= GSAData::DOP;
+      out.pdop = single(data.dop->pdop);
+      out.hdop = single(data.dop->hdop);
+      out.vdop = single(data.dop->vdop);
+    }
+  } else if constexpr (std::is_same_v<T, GSV>) {
+    GSVData &out = record.gsv;
+    out.total_messages = static_cast<std::uint8_t>(data.total_messages);
+    out.message_number = static_cast<std::uint8_t>(data.message_number);
+    out.satellites_in_view = static_cast<std::uint8_t>(data.satellites_in_view);
+    for (const types::Satellite &satellite : data.satellites) {
+      if (out.count < out.satellites.size()) {
+        out.satellites[out.count++] = {
+            static_cast<std::uint16_t>(satellite.prn),
+            detail::tenths(satellite.elevation),
+            detail::tenths(satellite.azimuth), detail::tenths(satellite.snr)};
+      }
+    }
+  } else if constexpr (std::is_same_v<T, RMC>) {
+    RMCData &out = record.rmc;
+    out.latitude =
+        detail::present(data.latitude, presence, RMCData::LATITUDE, degrees);
+    out.longitude =
+        detail::present(data.longitude, presence, RMCData::LONGITUDE, degrees);
+    out.speed = detail::present(
+        data.speed, presence, RMCData::SPEED,
+        [&](const auto &value) { return single(value.get_value()); });
+    out.course = detail::present(
+        data.course, presence, RMCData::COURSE,
+        [&](const auto &value) { return single(value.value_degrees()); });
+    out.magnetic_variation = detail::present(
+        data.magnetic_variation, presence, RMCData::MAGNETIC_VARIATION,
+        [&](const auto &value) { return single(value.value_degrees()); });
+    if (data.utc_date) {
+      presence |= RMCData::DATE;
+      out.year = data.utc_date->year;
+      out.month = data.utc_date->month;
+      out.day = data.utc_date->day;
+    }
+    out.status = detail::raw(data.status);
+    out.mode = detail::present(data.mode, presence, RMCData::MODE,
+                               detail::raw<types::Mode>);
+  } else if constexpr (std::is_same_v<T, VTG>) {
+    VTGData &out = record.vtg;
+    auto course = [&](const auto &value) {
+      return single(value.value_degrees());
+    };
+    auto speed = [&](const auto &value) { return single(value.get_value()); };
+    out.course_true = detail::present(data.course_true, presence,
+                                      VTGData::COURSE_TRUE, course);
+    out.course_magnetic = detail::present(data.course_magnetic, presence,
+                                          VTGData::COURSE_MAGNETIC, course);
+    out.speed_knots = detail::present(data.speed_knots, presence,
+                                      VTGData::SPEED_KNOTS, speed);
+    out.speed_kmh =
+        detail::present(data.speed_kmh, presence, VTGData::SPEED_KMH, speed);
+    out.mode = detail::present(data.mode, presence, VTGData::MODE,
+                               detail::raw<types::Mode>);
+  } else if constexpr (std::is_same_v<T, ZDA>) {
+    ZDAData &out = record.zda;
+    auto narrow = [](int value) { return static_cast<std::int8_t>(value); };
+    out.year = static_cast<std::uint16_t>(data.year);
+    out.month = static_cast<std::uint8_t>(data.month);
+    out.day = static_cast<std::uint8_t>(data.day);
+    out.local_zone_hours = detail::present(
+        data.local_zone_hours, presence, ZDAData::LOCAL_ZONE_HOURS, narrow);
+    out.local_zone_minutes = detail::present(
+        data.local_zone_minutes, presence, ZDAData::LOCAL_ZONE_MINUTES, narrow);
+  }
+
+  return record;
+}
+
+/// @brief Encodes one parsed sentence.
+inline Record encode(const Sample &sample) noexcept {
+  return std::visit([](const auto &data) { return encode(data); }, sample);
+}
+
+/// @brief Rebuilds the parsed sentence a record was encoded from. Satellite
+/// lists are allocated from @p resource.
+/// @return The sentence, or the error of the first enumeration byte out of
+/// range.
+inline std::expected<Sample, types::ParseError>
+decode(const Record &record, std::pmr::memory_resource *resource =
+                                 std::pmr::get_default_resource()) {
+  auto optional = [&](std::uint16_t bit, auto make) {
+    return record.has(bit) ? std::optional{make()} : std::nullopt;
+  };
+  auto valid = detail::validate(record);
+
+  if (!valid) {
+    return std::unexpected(valid.error());
+  }
+
+  const types::Type type = valid.value();
+  const types::Talker talker = *record.talker();
+  auto utc_time = record.utc_time();
+  // GSA carries PRNs only; the other satellite fields are missing.
+  constexpr double NAN_VALUE = std::numeric_limits<double>::quiet_NaN();
+
+  using enum types::Type;
+  switch (type) {
+  case GGA: {
+    const GGAData &in = record.gga;
+    return gga::GGA{
+        type,
+        talker,
+        utc_time,
+        optional(GGAData::LATITUDE,
+                 [&] { return detail::latitude(in.latitude); }),
+        optional(GGAData::LONGITUDE,
+                 [&] { return detail::longitude(in.longitude); }),
+        static_cast<types::FixQuality>(in.fix_quality),
+        in.satellites,
+        in.hdop,
+        optional(GGAData::ALTITUDE,
+                 [&] {
+                   return types::Altitude{
+                       in.altitude,
+                       static_cast<types::DistanceUnits>(in.altitude_units)};
+                 }),
+        optional(GGAData::GEOID_SEPARATION,
+                 [&] {
+                   return types::GeoidSeparation{
+                       in.geoid_separation,
+                       static_cast<types::DistanceUnits>(in.geoid_units)};
+                 }),
+        optional(GGAData::AGE_OF_DGPS,
+                 [&] { return types::AgeOfDgps{in.age_of_dgps}; }),
+        optional(GGAData::DGPS_STATION_ID,
+                 [&] { return types::DgpsStationId{in.dgps_station_id}; })};
+  }
+  case GLL: {
+    const GLLData &in = record.gll;
+    return gll::GLL{
+        type,
+        talker,
+        optional(GLLData::LATITUDE,
+                 [&] { return detail::latitude(in.latitude); }),
+        optional(GLLData::LONGITUDE,
+                 [&] { return detail::longitude(in.longitude); }),
+        utc_time,
+        static_cast<types::Status>(in.status),
+        optional(GLLData::MODE,
+                 [&] { return static_cast<types::Mode>(in.mode); })};
+  }
+  case GSA: {
+    const GSAData &in = record.gsa;
+    gsa::GSA out{type,
+                 talker,
+                 static_cast<types::SelectionMode>(in.selection_mode),
+                 static_cast<types::FixType>(in.fix_type),
+                 std::pmr::vector<types::Satellite>{resource},
+                 optional(GSAData::DOP, [&] {
+                   return types::DOP{in.pdop, in.hdop, in.vdop};
+                 })};
+    for (std::size_t i = 0; i < in.count && i < in.prns.size(); i++) {
+      out.satellites.push_back({in.prns[i], NAN_VALUE, NAN_VALUE, NAN_VALUE});
+    }
+    return out;
+  }
+  case GSV: {
+    const GSVData &in = record.gsv;
+    gsv::GSV out{type,
+                 talker,
+                 in.total_messages,
+                 in.message_number,
+                 in.satellites_in_view,
+                 std::pmr::vector<types::Satellite>{resource}};
+    for (std::size_t i = 0; i < in.count && i < in.satellites.size(); i++) {
+      const GSVData::Satellite &satellite = in.satellites[i];
+      out.satellites.push_back({satellite.prn,
+                                detail::from_tenths(satellite.elevation),
+                                detail::from_tenths(satellite.azimuth),
+                                detail::from_tenths(satellite.snr)});
+    }
+    return out;
+  }
+  case RMC: {
+    const RMCData &in = record.rmc;
+    return rmc::RMC{
+        type,
+        talker,
+        utc_time,
+        static_cast<types::Status>(in.status),
+        optional(RMCData::LATITUDE,
+                 [&] { return detail::latitude(in.latitude); }),
+        optional(RMCData::LONGITUDE,
+                 [&] { return detail::longitude(in.longitude); }),
+        optional(RMCData::SPEED, [&] { return types::Speed{in.speed}; }),
+        optional(RMCData::COURSE, [&] { return types::Course{in.course}; }),
+        optional(RMCData::DATE,
+                 [&] {
+                   return types::UTCDate{in.day, in.month, in.year};
+                 }),
+        optional(RMCData::MAGNETIC_VARIATION,
+                 [&] {
+                   return detail::magnetic_variation(in.magnetic_variation);
+                 }),
+        optional(RMCData::MODE,
+                 [&] { return static_cast<types::Mode>(in.mode); })};
+  }
+  case VTG: {
+    const VTGData &in = record.vtg;
+    return vtg::VTG{
+        type,
+        talker,
+        optional(VTGData::COURSE_TRUE,
+                 [&] { return types::Course{in.course_true}; }),
+        optional(VTGData::COURSE_MAGNETIC,
+                 [&] { return types::Course{in.course_magnetic}; }),
+        optional(VTGData::SPEED_KNOTS,
+                 [&] {
+                   return types::Speed{in.speed_knots,
+                                       types::SpeedUnits::knots};
+                 }),
+        optional(VTGData::SPEED_KMH,
+                 [&] {
+                   return types::Speed{in.speed_kmh, types::SpeedUnits::kmh};
+                 }),
+        optional(VTGData::MODE,
+                 [&] { return static_cast<types::Mode>(in.mode); })};
+  }
+  case ZDA: {
+    const ZDAData &in = record.zda;
+    return zda::ZDA{
+        type,
+        talker,
+        utc_time,
+        in.day,
+        in.month,
+        in.year,
+        optional(ZDAData::LOCAL_ZONE_HOURS,
+                 [&] { return int{in.local_zone_hours}; }),
+        optional(ZDAData::LOCAL_ZONE_MINUTES,
+                 [&] { return int{in.local_zone_minutes}; })};
+  }
+  }
+
+  return std::unexpected(types::ParseError::UnsupportedType);
+}
+
+/// @brief Appends records to a new record file.
+///
+/// Example:
+/// @code
+/// auto writer = cnmea::record::Writer::create("drive.cnr");
+/// cnmea::bulk::parse_file("drive.nmea", [&](const cnmea::Result &result) {
+///   if (result) {
+///     writer->write(result.value());
+///   }
+/// });
+/// writer->close();
+/// @endcode
+class Writer {
+public:
+  /// @brief Creates or truncates @p path and writes the file header.
+  static std::expected<Writer, types::ParseError>
+  create(const std::filesystem::path &path) {
+    Writer writer{std::ofstream{path, std::ios::binary | std::ios::trunc}};
+    FileHeader header{};
+    writer.stream.write(reinterpret_cast<const char *>(&header),
+                        sizeof(header));
+
+    if (!writer.stream) {
+      return std::unexpected(types::ParseError::IOError);
+    }
+
+    return writer;
+  }
+
+  void write(const Record &record) {
+    stream.write(reinterpret_cast<const char *>(&record), sizeof(record));
+    written++;
+  }
+
+  void write(const Sample &sample) { write(encode(sample)); }
+
+  /// @brief Number of records written so far.
+  std::size_t size() const noexcept { return written; }
+
+  /// @brief Flushes and closes the file, reporting any write error.
+  std::expected<void, types::ParseError> close() {
+    stream.close();
+
+    if (!stream) {
+      return std::unexpected(types::ParseError::IOError);
+    }
+
+    return {};
+  }
+
+private:
+  std::ofstream stream;
+  std::size_t written{0};
+
+  explicit Writer(std::ofstream stream) : stream(std::move(stream)) {}
+};
+
+/// @brief Memory-mapped, read-only view of a record file.
+class Reader {
+public:
+  /// @brief Maps @p path and validates its header.
+  static std::expected<Reader, types::ParseError>
+  open(const std::filesystem::path &path) noexcept {
+    auto file = bulk::map_file(path);
+
+    if (!file) {
+      return std::unexpected(file.error());
+    }
+
+    std::string_view bytes = file->view();
+    FileHeader header{};
+
+    if (bytes.size() < sizeof(header)) {
+      return std::unexpected(types::ParseError::InvalidFormat);
+    }
+
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    if (header.magic != MAGIC || header.version != VERSION ||
+        header.endian_mark != ENDIAN_MARK ||
+        header.header_size != sizeof(FileHeader) ||
+        header.record_size != sizeof(Record) ||
+        (bytes.size() - sizeof(header)) % sizeof(Record) != 0) {
+      return std::unexpected(types::ParseError::InvalidFormat);
+    }
+
+    return Reader{std::move(file.value())};
+  }
+
+  /// @brief Every record, read in place from the mapping. Their bytes are
+  /// not checked; read() or decode() does that.
+  std::span<const Record> records() const noexcept {
+    std::string_view bytes = file.view();
+    return {reinterpret_cast<const Record *>(bytes.data() + sizeof(FileHeader)),
+            (bytes.size() - sizeof(FileHeader)) / sizeof(Record)};
+  }
+
+  std::size_t size() const noexcept { return records().size(); }
+
+  const Record &operator[](std::size_t index) const noexcept {
+    return records()[index];
+  }
+
+  auto begin() const noexcept { return records().begin(); }
+  auto end() const noexcept { return records().end(); }
+
+  /// @brief Decodes the record at @p index, or reports why it is corrupt.
+  std::expected<Sample, types::ParseError>
+  read(std::size_t index, std::pmr::memory_resource *resource =
+                              std::pmr::get_default_resource()) const {
+    return decode(records()[index], resource);
+  }
+
+private:
+  bulk::MappedFile file;
+
+  explicit Reader(bulk::MappedFile file) : file(std::move(file)) {}
+};
+
+/// @brief Parses the NMEA log at @p log and stores every successfully
+/// parsed sentence in a record file at @p output.
+/// @return The number of records written.
+inline std::expected<std::size_t, types::ParseError>
+convert(const std::filesystem::path &log,
+        const std::filesystem::path &output) {
+  auto writer = Writer::create(output);
+
+  if (!writer) {
+    return std::unexpected(writer.error());
+  }
+
+  auto parsed = bulk::parse_file(log, [&](const Result &result) {
+    if (result) {
+      writer->write(result.value());
+    }
+  });
+
+  if (!parsed) {
+    return std::unexpected(parsed.error());
+  }
+
+  if (auto closed = writer->close(); !closed) {
+    return std::unexpected(closed.error());
+  }
+
+  return writer->size();
+}
+
+} // namespace cnmea::record
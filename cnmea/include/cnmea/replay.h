@@ -0,0 +1,480 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "bulk.h"
+#include "epoch.h"
+#include "gga.h"
+#include "gll.h"
+#include "rmc.h"
+#include "tools.h"
+#include "types.h"
+#include "zda.h"
+
+/**
+ * @namespace cnmea::replay
+ * @brief Timed replay of recorded logs, e.g. onto pseudo-terminals that
+ * unmodified serial readers attach to.
+ */
+namespace cnmea::replay {
+
+/// @brief The sentences a receiver sent for one epoch: a contiguous byte
+/// range of the log, line endings included.
+struct Epoch {
+  std::int64_t offset_ns; ///< Time since the first epoch of the log
+  std::size_t begin;      ///< Offset of the first sentence in the log
+  std::size_t end;        ///< Offset past the last sentence
+  std::size_t sentences;  ///< Sentences in the range
+};
+
+/// @brief UTC time of a sentence that carries one (GGA, GLL, RMC, ZDA).
+///
+/// Only the time field is decoded, through the lazy per-type views.
+inline std::optional<types::UTCTime>
+sentence_time(std::string_view sentence) noexcept {
+  auto header = tools::parse_header(sentence);
+
+  if (!header) {
+    return std::nullopt;
+  }
+
+  auto time_of = [sentence]<typename View>(std::type_identity<View>)
+      -> std::optional<types::UTCTime> {
+    auto view = make_view<View>(sentence);
+    if (!view) {
+      return std::nullopt;
+    }
+    return view->utc_time();
+  };
+
+  using enum types::Type;
+  switch (header->type) {
+  case GGA:
+    return time_of(std::type_identity<gga::View>{});
+  case GLL:
+    return time_of(std::type_identity<gll::View>{});
+  case RMC:
+    return time_of(std::type_identity<rmc::View>{});
+  case ZDA:
+    return time_of(std::type_identity<zda::View>{});
+  default:
+    return std::nullopt;
+  }
+}
+
+/// @brief A log split into epochs, each with its offset from the start.
+///
+/// A sentence whose UTC time differs from the current epoch's starts a new
+/// epoch; sentences without a time (GSA, GSV, VTG) or that fail to parse
+/// join the epoch in progress. Crossing midnight is handled as in
+/// EpochResolver, and offsets never decrease, so a time jumping backwards
+/// replays immediately rather than stalling.
+///
+/// The schedule refers to the log by offsets: a schedule built from a
+/// buffer must not outlive it, while load() keeps the mapped file.
+class Schedule {
+public:
+  explicit Schedule(std::string_view log) : log(log) { build(); }
+
+  /// @brief Memory-maps @p path and builds its schedule.
+  static std::expected<Schedule, types::ParseError>
+  load(const std::filesystem::path &path) {
+    auto file = bulk::map_file(path);
+
+    if (!file) {
+      return std::unexpected(file.error());
+    }
+
+    return Schedule{std::move(file.value())};
+  }
+
+  std::span<const Epoch> epochs() const noexcept { return entries; }
+
+  /// @brief The bytes to send for @p epoch.
+  std::string_view bytes(const Epoch &epoch) const noexcept {
+    return log.substr(epoch.begin, epoch.end - epoch.begin);
+  }
+
+  /// @brief Offset of the last epoch.
+  std::int64_t duration_ns() const noexcept {
+    return entries.empty() ? 0 : entries.back().offset_ns;
+  }
+
+  /// @brief Time between epochs, estimated over the whole log; used to space
+  /// the end of one loop from the start of the next. One second when the
+  /// log holds a single epoch.
+  std::int64_t period_ns() const noexcept {
+    if (entries.size() < 2) {
+      return NS_PER_SECOND;
+    }
+    return std::max<std::int64_t>(
+        duration_ns() / static_cast<std::int64_t>(entries.size() - 1), 1);
+  }
+
+  std::size_t sentences() const noexcept { return total_sentences; }
+
+private:
+  static constexpr std::int64_t NS_PER_SECOND{1'000'000'000};
+
+  bulk::MappedFile file;
+  std::string_view log;
+  std::vector<Epoch> entries;
+  std::size_t total_sentences{0};
+
+  explicit Schedule(bulk::MappedFile mapped)
+      : file(std::move(mapped)), log(file.view()) {
+    build();
+  }
+
+  void build() {
+    std::optional<std::int64_t> current_ns;
+    std::int64_t first_ns = 0;
+    std::int64_t day_ns = 0;
+    std::int64_t offset_ns = 0;
+
+    auto start = [&](std::size_t begin) {
+      if (!entries.empty()) {
+        entries.back().end = begin;
+      }
+      entries.push_back({offset_ns, begin, log.size(), 0});
+    };
+
+    bulk::for_each_sentence(log, [&](std::string_view sentence) {
+      auto begin = static_cast<std::size_t>(sentence.data() - log.data());
+      auto time = sentence_time(sentence);
+
+      if (!time) {
+        if (entries.empty()) {
+          start(begin);
+        }
+      } else if (std::int64_t time_ns = time->to_duration().count();
+                 !current_ns) {
+        // Untimed sentences before the first timed one join its epoch.
+        first_ns = time_ns;
+        current_ns = time_ns;
+        if (entries.empty()) {
+          start(begin);
+        }
+      } else if (time_ns != current_ns.value()) {
+        if (current_ns.value() - time_ns > EpochResolver::NS_PER_DAY / 2) {
+          day_ns += EpochResolver::NS_PER_DAY;
+        }
+        offset_ns = std::max(offset_ns, day_ns + time_ns - first_ns);
+        current_ns = time_ns;
+        start(begin);
+      }
+
+      entries.back().sentences++;
+      total_sentences++;
+    });
+  }
+};
+
+/// @brief A pseudo-terminal pair in raw mode, closed on destruction.
+///
+/// Programs open name() exactly like a serial port. The replica side is
+/// kept open as well, so that readers may attach and detach at any time;
+/// writes to fd() never block, and what the terminal cannot buffer while
+/// nobody reads is dropped.
+class PseudoTerminal {
+private:
+  int primary{-1};
+  int replica{-1};
+  std::string path;
+
+public:
+  PseudoTerminal() = default;
+
+  PseudoTerminal(const PseudoTerminal &) = delete;
+  PseudoTerminal &operator=(const PseudoTerminal &) = delete;
+
+  PseudoTerminal(PseudoTerminal &&other) noexcept
+      : primary(std::exchange(other.primary, -1)),
+        replica(std::exchange(other.replica, -1)),
+        path(std::move(other.path)) {}
+
+  PseudoTerminal &operator=(PseudoTerminal &&other) noexcept {
+    if (this != &other) {
+      close();
+      primary = std::exchange(other.primary, -1);
+      replica = std::exchange(other.replica, -1);
+      path = std::move(other.path);
+    }
+    return *this;
+  }
+
+  ~PseudoTerminal() { close(); }
+
+  /// @brief Allocates a new pseudo-terminal.
+  static std::expected<PseudoTerminal, types::ParseError> open() {
+    PseudoTerminal terminal;
+    terminal.primary = ::posix_openpt(O_RDWR | O_NOCTTY);
+
+    char name[128];
+    if (terminal.primary < 0 || ::grantpt(terminal.primary) != 0 ||
+        ::unlockpt(terminal.primary) != 0 ||
+        ::ptsname_r(terminal.primary, name, sizeof(name)) != 0) {
+      return std::unexpected(types::ParseError::IOError);
+    }
+    terminal.path = name;
+
+    terminal.replica = ::open(name, O_RDWR | O_NOCTTY);
+
+    struct termios mode{};
+    if (terminal.replica < 0 || ::tcgetattr(terminal.replica, &mode) != 0) {
+      return std::unexpected(types::ParseError::IOError);
+    }
+    ::cfmakeraw(&mode);
+    if (::tcsetattr(terminal.replica, TCSANOW, &mode) != 0) {
+      return std::unexpected(types::ParseError::IOError);
+    }
+
+    int flags = ::fcntl(terminal.primary, F_GETFL);
+    if (flags < 0 ||
+        ::fcntl(terminal.primary, F_SETFL, flags | O_NONBLOCK) != 0) {
+      return std::unexpected(types::ParseError::IOError);
+    }
+
+    return terminal;
+  }
+
+  /// @brief Descriptor to write the receiver's output to.
+  int fd() const noexcept { return primary; }
+
+  /// @brief Device path readers open, e.g. `/dev/pts/3`.
+  const std::string &name() const noexcept { return path; }
+
+private:
+  void close() noexcept {
+    if (replica >= 0) {
+      ::close(replica);
+      replica = -1;
+    }
+    if (primary >= 0) {
+      ::close(primary);
+      primary = -1;
+    }
+  }
+};
+
+/// @brief Replay speed and repetition.
+struct Options {
+  /// Multiple of real time: 1 replays at the recorded rate, 10 ten times
+  /// faster. Zero or less sends every epoch as soon as possible.
+  double speed{1.0};
+  /// Passes over the log per receiver; 0 repeats until stopped.
+  std::size_t loops{1};
+};
+
+/// @brief What one receiver sent.
+struct Stats {
+  std::size_t epochs{0};
+  std::size_t sentences{0};
+  std::size_t bytes{0};
+  std::size_t dropped_bytes{0}; ///< Not accepted by a non-blocking sink
+  std::int64_t log_ns{0};       ///< Log time covered, loops included
+};
+
+/// @brief Outcome of Replayer::run().
+struct Report {
+  double requested_speed{0.0}; ///< Options::speed; 0 for as fast as possible
+  double achieved_speed{0.0};  ///< Log time covered per wall-clock time
+  double wall_seconds{0.0};
+  Stats total;                 ///< Sums over all receivers; log_ns is the max
+  std::int64_t max_lag_ns{0};  ///< Worst lateness of an epoch vs. schedule
+
+  double sentences_per_second() const noexcept {
+    return wall_seconds > 0.0
+               ? static_cast<double>(total.sentences) / wall_seconds
+               : 0.0;
+  }
+};
+
+/// @brief Replays schedules onto file descriptors, one per virtual receiver.
+///
+/// A single thread serves every receiver: the next epoch of each is kept in
+/// a priority queue by due time, and the thread sleeps until the earliest
+/// one. Epoch bytes are written straight from the log with one write() each.
+/// Receivers sharing a schedule share its log; only a cursor is kept per
+/// receiver.
+///
+/// Example:
+/// @code
+/// auto schedule = cnmea::replay::Schedule::load("drive.nmea");
+/// auto terminal = cnmea::replay::PseudoTerminal::open();
+/// std::println("attach to {}", terminal->name());
+///
+/// cnmea::replay::Replayer replayer;
+/// replayer.add(*schedule, terminal->fd());
+/// auto report = replayer.run({.speed = 10.0});
+/// @endcode
+class Replayer {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /// @brief Adds a receiver writing @p schedule to @p fd, which both must
+  /// outlive run().
+  /// @return The receiver's ID, its index in stats().
+  std::size_t add(const Schedule &schedule, int fd) {
+    receivers.push_back({&schedule, fd, 0, 0, 0});
+    return receivers.size() - 1;
+  }
+
+  /// @brief Per-receiver statistics of the last run().
+  std::span<const Stats> stats() const noexcept { return results; }
+
+  /// @brief Replays every receiver until all loops are done or @p stop is
+  /// requested.
+  Report run(const Options &options, std::stop_token stop = {}) {
+    results.assign(receivers.size(), Stats{});
+
+    struct Due {
+      std::int64_t log_ns;
+      std::size_t receiver;
+      bool operator>(const Due &other) const noexcept {
+        return log_ns > other.log_ns;
+      }
+    };
+    std::priority_queue<Due, std::vector<Due>, std::greater<>> queue;
+
+    for (std::size_t id = 0; id < receivers.size(); id++) {
+      Receiver &receiver = receivers[id];
+      receiver.next = 0;
+      receiver.loop = 0;
+      receiver.base_ns = 0;
+      if (!receiver.schedule->epochs().empty()) {
+        queue.push({receiver.schedule->epochs().front().offset_ns, id});
+      }
+    }
+
+    Report report;
+    report.requested_speed = std::max(options.speed, 0.0);
+
+    const Clock::time_point start = Clock::now();
+    Clock::time_point last_write = start;
+
+    while (!queue.empty() && !stop.stop_requested()) {
+      Due due = queue.top();
+      queue.pop();
+
+      if (options.speed > 0.0) {
+        auto deadline =
+            start + std::chrono::nanoseconds{static_cast<std::int64_t>(
+                        static_cast<double>(due.log_ns) / options.speed)};
+        if (!sleep_until(deadline, stop)) {
+          break;
+        }
+        report.max_lag_ns =
+            std::max(report.max_lag_ns,
+                     static_cast<std::int64_t>(
+                         std::chrono::nanoseconds{Clock::now() - deadline}
+                             .count()));
+      }
+
+      Receiver &receiver = receivers[due.receiver];
+      const Schedule &schedule = *receiver.schedule;
+      const Epoch &epoch = schedule.epochs()[receiver.next];
+
+      send(receiver.fd, schedule.bytes(epoch), results[due.receiver]);
+      Stats &stats = results[due.receiver];
+      stats.epochs++;
+      stats.sentences += epoch.sentences;
+      stats.log_ns = due.log_ns;
+      last_write = Clock::now();
+
+      if (++receiver.next == schedule.epochs().size()) {
+        receiver.next = 0;
+        receiver.base_ns += schedule.duration_ns() + schedule.period_ns();
+        if (options.loops != 0 && ++receiver.loop == options.loops) {
+          continue;
+        }
+      }
+
+      queue.push({receiver.base_ns + schedule.epochs()[receiver.next].offset_ns,
+                  due.receiver});
+    }
+
+    report.wall_seconds =
+        std::chrono::duration<double>(last_write - start).count();
+
+    for (const Stats &stats : results) {
+      report.total.epochs += stats.epochs;
+      report.total.sentences += stats.sentences;
+      report.total.bytes += stats.bytes;
+      report.total.dropped_bytes += stats.dropped_bytes;
+      report.total.log_ns = std::max(report.total.log_ns, stats.log_ns);
+    }
+
+    if (report.wall_seconds > 0.0) {
+      report.achieved_speed =
+          static_cast<double>(report.total.log_ns) / 1e9 / report.wall_seconds;
+    }
+
+    return report;
+  }
+
+private:
+  struct Receiver {
+    const Schedule *schedule;
+    int fd;
+    std::size_t next;     ///< Index of the next epoch to send
+    std::size_t loop;     ///< Completed passes over the log
+    std::int64_t base_ns; ///< Log time at which the current pass started
+  };
+
+  std::vector<Receiver> receivers;
+  std::vector<Stats> results;
+
+  /// Sleeps in short slices so that a stop request is honoured promptly.
+  static bool sleep_until(Clock::time_point deadline, std::stop_token stop) {
+    constexpr std::chrono::milliseconds SLICE{100};
+
+    for (auto now = Clock::now(); now < deadline; now = Clock::now()) {
+      if (stop.stop_requested()) {
+        return false;
+      }
+      std::this_thread::sleep_until(std::min(deadline, now + SLICE));
+    }
+    return !stop.stop_requested();
+  }
+
+  static void send(int fd, std::string_view bytes, Stats &stats) noexcept {
+    while (!bytes.empty()) {
+      ssize_t written = ::write(fd, bytes.data(), bytes.size());
+
+      if (written < 0 && errno == EINTR) {
+        continue;
+      }
+      if (written <= 0) {
+        break;
+      }
+      stats.bytes += static_cast<std::size_t>(written);
+      bytes.remove_prefix(static_cast<std::size_t>(written));
+    }
+    stats.dropped_bytes += bytes.size();
+  }
+};
+
+} // namespace cnmea::replay
@@ -6,14 +6,18 @@
 #include <string_view>
 
 #include "p_tools.h"
+#include "schema.h"
+#include "serialize.h"
 #include "tools.h"
 #include "types.h"
+#include "view.h"
 
 namespace cnmea::rmc {
 
 struct RMC {
   types::Type type;
-  types::UTCTime utc_time;
+  types::Talker talker;
+  std::optional<types::UTCTime> utc_time;
   types::Status status;
   std::optional<types::Latitude> latitude;
   std::optional<types::Longitude> longitude;
@@ -22,35 +26,108 @@ struct RMC {
   std::optional<types::UTCDate> utc_date;
   std::optional<types::MagneticVariation> magnetic_variation;
   std::optional<types::Mode> mode;
+
+  bool operator==(const RMC &) const = default;
 };
 
-inline std::expected<RMC, types::ParseError> parse(std::string_view sample) {
-  if (!tools::is_valid_sample(sample)) {
-    return std::unexpected(types::ParseError::InvalidFormat);
+/// @brief Field layout; MIN_FIELDS and the parsers are generated from it.
+using Layout = schema::Layout<
+    RMC, types::Type::RMC,
+    schema::Field<&RMC::utc_time, &tools::parse_utc_time, 1>,
+    schema::Field<&RMC::status, &tools::parse_status, 2>,
+    schema::Field<&RMC::latitude, &tools::parse_latitude, 3, 4>,
+    schema::Field<&RMC::longitude, &tools::parse_longitude, 5, 6>,
+    schema::Field<&RMC::speed,
+                  schema::bind_back<&tools::parse_speed,
+                                    types::SpeedUnits::knots>,
+                  7>,
+    schema::Field<&RMC::course, &tools::parse_course, 8>,
+    schema::Field<&RMC::utc_date, &tools::parse_utc_date, 9>,
+    schema::OptionalField<&RMC::magnetic_variation,
+                          &tools::parse_magnetic_variation, 10, 11>,
+    schema::OptionalField<&RMC::mode, &tools::parse_mode, 12>>;
+
+/// @brief Minimum number of fields, header included.
+/// Magnetic variation and the mode indicator are optional.
+constexpr std::size_t MIN_FIELDS{Layout::MIN_FIELDS};
+
+inline std::expected<RMC, types::ParseError>
+parse(const types::Header &header, const tools::Tokens &tokens) noexcept {
+  return Layout::parse(header, tokens);
+}
+
+inline std::expected<RMC, types::ParseError>
+parse(std::string_view sample) noexcept {
+  return Layout::parse(sample);
+}
+
+/// @brief Writes @p data into @p buffer as a complete sentence, checksum
+/// and CRLF included, without allocating.
+/// @return The sentence length, or BufferOverflow when @p buffer is too
+/// small.
+inline std::expected<std::size_t, types::ParseError>
+encode(const RMC &data, std::span<char> buffer) noexcept {
+  serialize::SentenceWriter out{buffer};
+  out.begin(data.talker, data.type);
+  out.time(data.utc_time);
+  out.field(data.status == types::Status::Valid ? 'A' : 'V');
+  out.latitude(data.latitude);
+  out.longitude(data.longitude);
+  if (data.speed) {
+    out.number(serialize::speed_token(data.speed.value()));
+  } else {
+    out.empty();
+  }
+  if (data.course) {
+    out.number(data.course->value_degrees());
+  } else {
+    out.empty();
+  }
+  out.date(data.utc_date);
+  if (data.magnetic_variation) {
+    out.number(data.magnetic_variation->get_degrees());
+    out.field(data.magnetic_variation->get_direction() ==
+                      types::Direction::East
+                  ? 'E'
+                  : 'W');
+  } else {
+    out.empty();
+    out.empty();
   }
+  if (data.mode) {
+    out.field(serialize::mode_code(data.mode.value()));
+  }
+  return out.finish();
+}
 
-  auto tokens = tools::tokenize(sample);
+/// @brief RMC sentence decoded field by field on access; see SentenceView.
+class View : public SentenceView<Layout> {
+public:
+  using SentenceView::SentenceView;
 
-  if (tokens.empty()) {
-    return std::unexpected(types::ParseError::UnknownError);
+  decltype(auto) utc_time() const noexcept { return get<&RMC::utc_time>(); }
+  decltype(auto) status() const noexcept { return get<&RMC::status>(); }
+  decltype(auto) latitude() const noexcept { return get<&RMC::latitude>(); }
+  decltype(auto) longitude() const noexcept { return get<&RMC::longitude>(); }
+  decltype(auto) speed() const noexcept { return get<&RMC::speed>(); }
+  decltype(auto) course() const noexcept { return get<&RMC::course>(); }
+  decltype(auto) utc_date() const noexcept { return get<&RMC::utc_date>(); }
+  decltype(auto) magnetic_variation() const noexcept {
+    return get<&RMC::magnetic_variation>();
   }
+  decltype(auto) mode() const noexcept { return get<&RMC::mode>(); }
+};
 
-  return RMC{
-      tools::parse_type(tokens.at(0)),
-      tools::parse_utc_time(tokens.at(1)),
-      tools::parse_status(tokens.at(2)),
-      tools::parse_latitude(tokens.at(3), tokens.at(4)),
-      tools::parse_longitude(tokens.at(5), tokens.at(6)),
-      tools::parse_speed(tokens.at(7)),
-      tools::parse_course(tokens.at(8)),
-      tools::parse_utc_date(tokens.at(9)),
-      tools::parse_magnetic_variation(tokens.at(10), tokens.at(11)),
-      tools::parse_mode(tokens.at(12)),
-  };
+/// @brief Validates @p sample and returns a View over it without decoding
+/// any field.
+inline std::expected<View, types::ParseError>
+view(std::string_view sample) noexcept {
+  return make_view<View>(sample);
 }
 
 inline void print(const RMC &data) {
   std::println("Type: {}", p_tools::to_string(data.type));
+  std::println("Talker: {}", p_tools::to_string(data.talker));
   std::println("Status: {}", p_tools::to_string(data.status));
   std::println("UTC Date: {}", p_tools::to_string(data.utc_date));
   std::println("UTC Time: {}", p_tools::to_string(data.utc_time));
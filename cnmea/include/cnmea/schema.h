@@ -0,0 +1,261 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <expected>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include "tools.h"
+#include "types.h"
+
+/**
+ * @namespace cnmea::schema
+ * @brief Compile-time sentence layouts that generate the per-type parsers.
+ *
+ * A sentence is described once as a Layout: its struct, its type and
+ * one entry per member naming the decoder and the token indices it reads.
+ * From that table the layout derives MIN_FIELDS and a parser in which every
+ * mandatory token is read without a bounds check, since the field count is
+ * verified once up front, and every decoder call is inlined.
+ *
+ * Example:
+ * @code
+ * using Layout = schema::Layout<
+ *     GLL, types::Type::GLL,
+ *     schema::Field<&GLL::latitude, &tools::parse_latitude, 1, 2>,
+ *     schema::Field<&GLL::status, &tools::parse_status, 6>,
+ *     schema::OptionalField<&GLL::mode, &tools::parse_mode, 7>>;
+ * @endcode
+ */
+namespace cnmea::schema {
+
+namespace detail {
+
+template <typename T> struct is_expected : std::false_type {};
+template <typename T, typename E>
+struct is_expected<std::expected<T, E>> : std::true_type {};
+
+template <std::size_t... Indices> constexpr std::size_t last_index() {
+  return std::max({Indices...});
+}
+
+/// Stands in for token @p Index in unevaluated decoder calls.
+template <std::size_t Index> std::string_view token() noexcept;
+
+/// Whether @p Decoder applied to the tokens at @p Indices can fail.
+template <auto Decoder, std::size_t... Indices>
+constexpr bool fallible() noexcept {
+  return is_expected<decltype(Decoder(token<Indices>()...))>::value;
+}
+
+template <auto A, auto B> constexpr bool same_member() noexcept {
+  if constexpr (std::is_same_v<decltype(A), decltype(B)>) {
+    return A == B;
+  } else {
+    return false;
+  }
+}
+
+/// Stores @p value into @p member. A decoder returning std::expected is
+/// mandatory: its error aborts the parse.
+template <typename Member, typename Value>
+constexpr std::optional<types::ParseError> store(Member &member,
+                                                 Value &&value) noexcept {
+  if constexpr (is_expected<std::remove_cvref_t<Value>>::value) {
+    if (!value) {
+      return value.error();
+    }
+    member = std::move(value.value());
+  } else {
+    member = std::forward<Value>(value);
+  }
+  return std::nullopt;
+}
+
+} // namespace detail
+
+/// @brief A member decoded from tokens that every sentence must carry.
+template <auto Member, auto Decoder, std::size_t... Indices> struct Field {
+  static constexpr auto MEMBER{Member};
+  /// Fields needed for this entry, header included.
+  static constexpr std::size_t REQUIRED{detail::last_index<Indices...>() + 1};
+  /// Whether decoding can reject the sentence.
+  static constexpr bool FALLIBLE{detail::fallible<Decoder, Indices...>()};
+
+  template <typename Sentence>
+  static std::optional<types::ParseError>
+  decode(Sentence &out, const tools::Tokens &tokens,
+         std::pmr::memory_resource *) noexcept {
+    return detail::store(out.*Member, Decoder(tokens[Indices]...));
+  }
+};
+
+/// @brief A member decoded from trailing tokens that older NMEA versions
+/// omit. Absent tokens reach the decoder as empty fields.
+template <auto Member, auto Decoder, std::size_t... Indices>
+struct OptionalField {
+  static constexpr auto MEMBER{Member};
+  static constexpr std::size_t REQUIRED{0};
+  static constexpr bool FALLIBLE{detail::fallible<Decoder, Indices...>()};
+
+  template <typename Sentence>
+  static std::optional<types::ParseError>
+  decode(Sentence &out, const tools::Tokens &tokens,
+         std::pmr::memory_resource *) noexcept {
+    return detail::store(out.*Member, Decoder(tokens.get(Indices)...));
+  }
+};
+
+/// @brief A token that must be present but is not decoded, such as the
+/// unit letter after a value whose unit is implied by its position.
+template <std::size_t Index> struct Skip {
+  static constexpr std::nullptr_t MEMBER{};
+  static constexpr std::size_t REQUIRED{Index + 1};
+  static constexpr bool FALLIBLE{false};
+
+  template <typename Sentence>
+  static std::optional<types::ParseError>
+  decode(Sentence &, const tools::Tokens &,
+         std::pmr::memory_resource *) noexcept {
+    return std::nullopt;
+  }
+};
+
+/// @brief A std::pmr::vector member filled from up to @p Capacity groups of
+/// @p Stride tokens starting at @p First. Groups that are missing, or that
+/// the decoder rejects, are skipped.
+template <auto Member, auto Decoder, std::size_t First, std::size_t Stride,
+          std::size_t Capacity>
+struct Repeated {
+  static constexpr auto MEMBER{Member};
+  static constexpr std::size_t REQUIRED{0};
+  static constexpr bool FALLIBLE{false};
+
+  template <typename Sentence>
+  static std::optional<types::ParseError>
+  decode(Sentence &out, const tools::Tokens &tokens,
+         std::pmr::memory_resource *resource) noexcept {
+    auto &items = out.*Member;
+    using Items = std::remove_cvref_t<decltype(items)>;
+    static_assert(std::is_same_v<typename Items::allocator_type,
+                                 std::pmr::polymorphic_allocator<
+                                     typename Items::value_type>>,
+                  "Repeated members must be std::pmr containers");
+
+    // Rebind the still empty, default-constructed container to @p resource.
+    std::destroy_at(&items);
+    std::construct_at(&items, resource);
+    items.reserve(Capacity);
+
+    for (std::size_t group = 0; group < Capacity; group++) {
+      std::size_t first = First + group * Stride;
+      if (first + Stride > tokens.size()) {
+        break;
+      }
+      decode_group(items, tokens, first, std::make_index_sequence<Stride>{});
+    }
+
+    return std::nullopt;
+  }
+
+private:
+  template <typename Items, std::size_t... Offsets>
+  static void decode_group(Items &items, const tools::Tokens &tokens,
+                           std::size_t first,
+                           std::index_sequence<Offsets...>) noexcept {
+    if (auto item = Decoder(tokens[first + Offsets]...)) {
+      items.push_back(std::move(item.value()));
+    }
+  }
+};
+
+/// @brief Adapts a decoder returning std::expected or std::optional into one
+/// that substitutes @p Fallback for a missing or malformed token.
+template <auto Decoder, auto Fallback>
+inline constexpr auto value_or = [](auto... tokens) noexcept {
+  return Decoder(tokens...).value_or(Fallback);
+};
+
+/// @brief Binds trailing arguments after the tokens, e.g. the unit of a
+/// speed field.
+template <auto Decoder, auto... Arguments>
+inline constexpr auto bind_back = [](auto... tokens) noexcept {
+  return Decoder(tokens..., Arguments...);
+};
+
+/// @brief The complete layout of one sentence type.
+template <typename Sentence, types::Type TYPE, typename... Fields>
+struct Layout {
+  using Output = Sentence;
+  /// @brief The entries in decode order.
+  using Entries = std::tuple<Fields...>;
+
+  static constexpr types::Type SENTENCE_TYPE{TYPE};
+
+  /// @brief Minimum number of fields, header included, derived from the
+  /// mandatory entries.
+  static constexpr std::size_t MIN_FIELDS{
+      std::max({std::size_t{1}, Fields::REQUIRED...})};
+
+  /// @brief Position in Entries of the entry decoding @p Member, or the
+  /// number of entries when no entry does.
+  template <auto Member> static constexpr std::size_t index_of() noexcept {
+    std::size_t index = 0;
+    std::size_t found = sizeof...(Fields);
+    ((detail::same_member<Fields::MEMBER, Member>() ? found = index : 0,
+      index++),
+     ...);
+    return found;
+  }
+
+  /// @brief Decodes the located fields of a sentence of this type.
+  static std::expected<Sentence, types::ParseError>
+  parse(const types::Header &header, const tools::Tokens &tokens,
+        std::pmr::memory_resource *resource =
+            std::pmr::get_default_resource()) noexcept {
+    if (tokens.size() < MIN_FIELDS) {
+      return std::unexpected(types::ParseError::MissingFields);
+    }
+
+    Sentence out{};
+    out.type = header.type;
+    out.talker = header.talker;
+
+    std::optional<types::ParseError> error;
+    // Stops at the first failing entry.
+    ((error = Fields::decode(out, tokens, resource), !error) && ...);
+
+    if (error) {
+      return std::unexpected(error.value());
+    }
+
+    return out;
+  }
+
+  /// @brief Validates, tokenizes and decodes a whole sentence.
+  static std::expected<Sentence, types::ParseError>
+  parse(std::string_view sample,
+        std::pmr::memory_resource *resource =
+            std::pmr::get_default_resource()) noexcept {
+    auto header = tools::parse_header(sample);
+
+    if (!header || header->type != TYPE) {
+      return std::unexpected(types::ParseError::UnsupportedType);
+    }
+
+    auto sentence = tools::scan(sample);
+
+    if (!sentence) {
+      return std::unexpected(sentence.error());
+    }
+
+    return parse(header.value(), sentence->tokens, resource);
+  }
+};
+
+} // namespace cnmea::schema
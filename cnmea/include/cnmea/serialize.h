@@ -0,0 +1,381 @@
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+
+#include "simd.h"
+#include "types.h"
+
+/**
+ * @namespace cnmea::serialize
+ * @brief Building blocks of the sentence encoders, the inverse of decode.
+ *
+ * Every encoder writes through a SentenceWriter into a caller-supplied
+ * buffer: numbers go through std::to_chars, nothing is allocated, and the
+ * checksum and CRLF are appended by finish().
+ */
+namespace cnmea::serialize {
+
+/// @brief Room for any sentence the encoders produce from in-range field
+/// values. NMEA 0183 caps sentences at 82 characters, but full-precision
+/// fields may exceed that. Larger values make finish() report
+/// BufferOverflow.
+constexpr std::size_t MAX_LENGTH{160};
+
+constexpr std::string_view talker_code(types::Talker talker) noexcept {
+  using enum types::Talker;
+  switch (talker) {
+  case GP:
+    return "GP";
+  case GL:
+    return "GL";
+  case GA:
+    return "GA";
+  case GB:
+    return "GB";
+  case GQ:
+    return "GQ";
+  case GI:
+    return "GI";
+  case GN:
+    return "GN";
+  case Unknown:
+    break;
+  }
+  return {};
+}
+
+constexpr std::string_view type_code(types::Type type) noexcept {
+  using enum types::Type;
+  switch (type) {
+  case GGA:
+    return "GGA";
+  case GLL:
+    return "GLL";
+  case GSA:
+    return "GSA";
+  case GSV:
+    return "GSV";
+  case RMC:
+    return "RMC";
+  case VTG:
+    return "VTG";
+  case ZDA:
+    return "ZDA";
+  }
+  return {};
+}
+
+/// @brief Mode indicator character, or '\0' for modes without one.
+constexpr char mode_code(types::Mode mode) noexcept {
+  using enum types::Mode;
+  switch (mode) {
+  case Autonomous:
+    return 'A';
+  case Differential:
+    return 'D';
+  case Estimated:
+    return 'E';
+  case ManualInput:
+    return 'M';
+  case Simulation:
+    return 'S';
+  case NotValid:
+    return 'N';
+  case Precise:
+    return 'P';
+  case RTKFixed:
+    return 'R';
+  case RTKFloat:
+    return 'F';
+  case Uncalibrated:
+    break;
+  }
+  return '\0';
+}
+
+constexpr std::string_view units_code(types::DistanceUnits units) noexcept {
+  using enum types::DistanceUnits;
+  switch (units) {
+  case m:
+    return "M";
+  case km:
+    return "KM";
+  case ft:
+    return "FT";
+  }
+  return {};
+}
+
+/// @brief The field value tools::parse_speed() turns into @p speed.
+inline double speed_token(const types::Speed &speed) noexcept {
+  using enum types::SpeedUnits;
+  switch (speed.get_units()) {
+  case ms:
+    return speed.get_value() / types::KNTOMS;
+  case kmh:
+    return speed.get_value() / types::KNTOKMH;
+  case knots:
+    break;
+  }
+  return speed.get_value();
+}
+
+/// @brief Appends the fields of one sentence to a caller-supplied buffer.
+///
+/// Writes past the end of the buffer are dropped and reported by finish(),
+/// so encoders write unconditionally and check once.
+///
+/// Example:
+/// @code
+/// char buffer[cnmea::serialize::MAX_LENGTH];
+/// cnmea::serialize::SentenceWriter out{buffer};
+/// out.begin(cnmea::types::Talker::GP, cnmea::types::Type::GLL);
+/// out.latitude(latitude);
+/// out.longitude(longitude);
+/// auto length = out.finish(); // "$GPGLL,...*hh\r\n"
+/// @endcode
+class SentenceWriter {
+public:
+  explicit SentenceWriter(std::span<char> buffer) noexcept : buffer(buffer) {}
+
+  /// @brief Writes the `$ttSSS` header.
+  void begin(types::Talker talker, types::Type type) noexcept {
+    std::string_view talker_text = talker_code(talker);
+    if (talker_text.empty()) {
+      error = types::ParseError::UnsupportedType;
+    }
+    put('$');
+    put(talker_text);
+    put(type_code(type));
+  }
+
+  void empty() noexcept { put(','); }
+
+  void field(char value) noexcept {
+    put(',');
+    if (value != '\0') {
+      put(value);
+    }
+  }
+
+  void field(std::string_view value) noexcept {
+    put(',');
+    put(value);
+  }
+
+  /// @brief A decimal number in its shortest round-trip form; NaN is
+  /// written as an empty field. Infinities have no field form and are
+  /// reported as BufferOverflow, like other values no receiver sends.
+  void number(double value) noexcept {
+    put(',');
+    if (std::isinf(value)) {
+      overflow = true;
+    } else if (!std::isnan(value)) {
+      convert(value, std::chars_format::fixed);
+    }
+  }
+
+  void number(std::optional<double> value) noexcept {
+    number(value.value_or(std::nan("")));
+  }
+
+  /// @brief An integer padded with zeros to @p width digits.
+  void integer(long long value, int width = 0) noexcept {
+    put(',');
+    // Negated as unsigned, which is defined for the minimum value too.
+    auto magnitude = static_cast<unsigned long long>(value);
+    if (value < 0) {
+      put('-');
+      magnitude = 0 - magnitude;
+    }
+    char digits[24];
+    auto [end, code] =
+        std::to_chars(digits, digits + sizeof(digits), magnitude);
+    for (auto count = end - digits; count < width; count++) {
+      put('0');
+    }
+    put(std::string_view{digits, static_cast<std::size_t>(end - digits)});
+  }
+
+  void integer(std::optional<int> value, int width = 0) noexcept {
+    if (!value) {
+      empty();
+      return;
+    }
+    integer(value.value(), width);
+  }
+
+  /// @brief A satellite angle or SNR: zero-padded when integral, as
+  /// receivers send it, otherwise a plain number.
+  void measure(double value, int width) noexcept {
+    // Values beyond long long, infinities and NaN go through number().
+    if (!(std::fabs(value) < MAX_INTEGRAL) || value != std::trunc(value)) {
+      number(value);
+      return;
+    }
+    integer(static_cast<long long>(value), width);
+  }
+
+  /// @brief hhmmss.ss, with as many further fractional digits as the
+  /// nanoseconds need.
+  void time(const std::optional<types::UTCTime> &time) noexcept {
+    put(',');
+    if (!time) {
+      return;
+    }
+    digits(time->hours, 2);
+    digits(time->minutes, 2);
+    digits(time->seconds, 2);
+    put('.');
+
+    std::uint32_t fraction = time->nanoseconds;
+    int width = 9;
+    while (width > 2 && fraction % 10 == 0) {
+      fraction /= 10;
+      width--;
+    }
+    digits(fraction, width);
+  }
+
+  /// @brief ddmmyy.
+  void date(const std::optional<types::UTCDate> &date) noexcept {
+    put(',');
+    if (!date) {
+      return;
+    }
+    digits(date->day, 2);
+    digits(date->month, 2);
+    digits(date->year % 100u, 2);
+  }
+
+  /// @brief ddmm.mmmmmm and the hemisphere, as two fields.
+  void latitude(const std::optional<types::Latitude> &latitude) noexcept {
+    if (!latitude) {
+      empty();
+      empty();
+      return;
+    }
+    coordinate(latitude->get_degrees(), 2, 90.0,
+               types::ParseError::InvalidLatitude);
+    field(latitude->get_direction() == types::Direction::North ? 'N' : 'S');
+  }
+
+  /// @brief dddmm.mmmmmm and the hemisphere, as two fields.
+  void longitude(const std::optional<types::Longitude> &longitude) noexcept {
+    if (!longitude) {
+      empty();
+      empty();
+      return;
+    }
+    coordinate(longitude->get_degrees(), 3, 180.0,
+               types::ParseError::InvalidLongitude);
+    field(longitude->get_direction() == types::Direction::East ? 'E' : 'W');
+  }
+
+  /// @brief Appends `*hh\r\n`.
+  /// @return The sentence length, or BufferOverflow when it did not fit.
+  std::expected<std::size_t, types::ParseError> finish() noexcept {
+    std::uint8_t check = 0;
+    if (!overflow && length > 1) {
+      check = simd::xor_reduce({buffer.data() + 1, length - 1});
+    }
+
+    constexpr std::string_view HEX{"0123456789ABCDEF"};
+    put('*');
+    put(HEX[check >> 4]);
+    put(HEX[check & 0x0F]);
+    put("\r\n");
+
+    if (error) {
+      return std::unexpected(error.value());
+    }
+    if (overflow) {
+      return std::unexpected(types::ParseError::BufferOverflow);
+    }
+    return length;
+  }
+
+private:
+  /// Fractional digits of a coordinate's minutes.
+  static constexpr int MINUTE_DIGITS{6};
+  static constexpr std::uint64_t MINUTE_SCALE{1'000'000};
+  /// Magnitude below which an integral double converts to long long.
+  static constexpr double MAX_INTEGRAL{1e18};
+
+  std::span<char> buffer;
+  std::size_t length{0};
+  bool overflow{false};
+  std::optional<types::ParseError> error;
+
+  void put(char c) noexcept {
+    if (length < buffer.size()) {
+      buffer[length++] = c;
+    } else {
+      overflow = true;
+    }
+  }
+
+  void put(std::string_view text) noexcept {
+    if (text.size() > buffer.size() - length) {
+      overflow = true;
+      length = buffer.size();
+      return;
+    }
+    text.copy(buffer.data() + length, text.size());
+    length += text.size();
+  }
+
+  void digits(std::uint64_t value, int width) noexcept {
+    char text[20];
+    for (int i = width - 1; i >= 0; i--) {
+      text[i] = static_cast<char>('0' + value % 10);
+      value /= 10;
+    }
+    put(std::string_view{text, static_cast<std::size_t>(width)});
+  }
+
+  void convert(double value, std::chars_format format) noexcept {
+    auto [end, code] = std::to_chars(buffer.data() + length,
+                                     buffer.data() + buffer.size(), value,
+                                     format);
+    if (code != std::errc{}) {
+      overflow = true;
+      length = buffer.size();
+      return;
+    }
+    length = static_cast<std::size_t>(end - buffer.data());
+  }
+
+  /// Rounds to whole micro-minutes first, so that a coordinate decoded
+  /// from up to six fractional digits is written back digit for digit.
+  /// Values that are not finite or exceed @p limit degrees leave the field
+  /// empty and make finish() report @p invalid.
+  void coordinate(double degrees, int degree_digits, double limit,
+                  types::ParseError invalid) noexcept {
+    put(',');
+    if (!(std::fabs(degrees) <= limit)) {
+      if (!error) {
+        error = invalid;
+      }
+      return;
+    }
+    auto scaled = static_cast<std::uint64_t>(
+        std::llround(std::fabs(degrees) * 60.0 * MINUTE_SCALE));
+    std::uint64_t per_degree = 60 * MINUTE_SCALE;
+    std::uint64_t remainder = scaled % per_degree;
+    digits(scaled / per_degree, degree_digits);
+    digits(remainder / MINUTE_SCALE, 2);
+    put('.');
+    digits(remainder % MINUTE_SCALE, MINUTE_DIGITS);
+  }
+};
+
+} // namespace cnmea::serialize
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if !defined(CNMEA_NO_SIMD) && defined(__GNUC__) && defined(__x86_64__)
+#define CNMEA_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @namespace cnmea::simd
+ * @brief Vectorised delimiter classification and checksum kernels.
+ *
+ * Input is processed in 64-byte blocks. On x86 an AVX2 or SSE2 kernel is
+ * chosen once at runtime from the CPU features; elsewhere, or when built
+ * with CNMEA_NO_SIMD, a portable scalar kernel is used. All kernels return
+ * identical results.
+ */
+namespace cnmea::simd {
+
+/// @brief Bytes per block handled by one classify() call.
+constexpr std::size_t BLOCK{64};
+
+/// @brief Positions of the NMEA structural characters within a block.
+/// Bit i of each mask corresponds to byte i of the block.
+struct Block {
+  std::uint64_t comma;   ///< `,`
+  std::uint64_t star;    ///< `*`
+  std::uint64_t start;   ///< `$` or `!`
+  std::uint64_t newline; ///< CR or LF
+};
+
+namespace detail {
+
+inline Block classify_scalar(const char *data) noexcept {
+  Block block{0, 0, 0, 0};
+  for (std::size_t i = 0; i < BLOCK; i++) {
+    std::uint64_t bit = std::uint64_t{1} << i;
+    switch (data[i]) {
+    case ',':
+      block.comma |= bit;
+      break;
+    case '*':
+      block.star |= bit;
+      break;
+    case '$':
+    case '!':
+      block.start |= bit;
+      break;
+    case '\r':
+    case '\n':
+      block.newline |= bit;
+      break;
+    default:
+      break;
+    }
+  }
+  return block;
+}
+
+/// XOR of the eight bytes of @p word.
+constexpr std::uint8_t fold(std::uint64_t word) noexcept {
+  word ^= word >> 32;
+  word ^= word >> 16;
+  word ^= word >> 8;
+  return static_cast<std::uint8_t>(word);
+}
+
+inline std::uint8_t xor_scalar(const char *data, std::size_t size) noexcept {
+  std::uint64_t folded = 0;
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, data + i, 8);
+    folded ^= word;
+  }
+  std::uint8_t check = fold(folded);
+  for (; i < size; i++) {
+    check ^= static_cast<std::uint8_t>(data[i]);
+  }
+  return check;
+}
+
+#ifdef CNMEA_SIMD_X86
+
+inline std::uint64_t mask16(__m128i chunk, char c) noexcept {
+  return static_cast<std::uint16_t>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(c))));
+}
+
+inline Block classify_sse2(const char *data) noexcept {
+  Block block{0, 0, 0, 0};
+  for (std::size_t i = 0; i < BLOCK; i += 16) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    block.comma |= mask16(chunk, ',') << i;
+    block.star |= mask16(chunk, '*') << i;
+    block.start |= (mask16(chunk, '$') | mask16(chunk, '!')) << i;
+    block.newline |= (mask16(chunk, '\r') | mask16(chunk, '\n')) << i;
+  }
+  return block;
+}
+
+inline std::uint8_t xor_sse2(const char *data, std::size_t size) noexcept {
+  __m128i folded = _mm_setzero_si128();
+  std::size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    folded = _mm_xor_si128(
+        folded, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)));
+  }
+  folded = _mm_xor_si128(folded, _mm_srli_si128(folded, 8));
+  return static_cast<std::uint8_t>(
+      fold(static_cast<std::uint64_t>(_mm_cvtsi128_si64(folded))) ^
+      xor_scalar(data + i, size - i));
+}
+
+__attribute__((target("avx2"))) inline std::uint64_t mask32(__m256i chunk,
+                                                             char c) noexcept {
+  return static_cast<std::uint32_t>(
+      _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(c))));
+}
+
+__attribute__((target("avx2"))) inline Block
+classify_avx2(const char *data) noexcept {
+  Block block{0, 0, 0, 0};
+  for (std::size_t i = 0; i < BLOCK; i += 32) {
+    __m256i chunk =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+    block.comma |= mask32(chunk, ',') << i;
+    block.star |= mask32(chunk, '*') << i;
+    block.start |= (mask32(chunk, '$') | mask32(chunk, '!')) << i;
+    block.newline |= (mask32(chunk, '\r') | mask32(chunk, '\n')) << i;
+  }
+  return block;
+}
+
+__attribute__((target("avx2"))) inline std::uint8_t
+xor_avx2(const char *data, std::size_t size) noexcept {
+  __m256i folded = _mm256_setzero_si256();
+  std::size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    folded = _mm256_xor_si256(
+        folded,
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)));
+  }
+  __m128i half = _mm_xor_si128(_mm256_castsi256_si128(folded),
+                               _mm256_extracti128_si256(folded, 1));
+  half = _mm_xor_si128(half, _mm_srli_si128(half, 8));
+  return static_cast<std::uint8_t>(
+      fold(static_cast<std::uint64_t>(_mm_cvtsi128_si64(half))) ^
+      xor_sse2(data + i, size - i));
+}
+
+#endif
+
+/// @brief The kernels selected for this CPU.
+struct Kernels {
+  Block (*classify)(const char *) noexcept;
+  std::uint8_t (*xor_reduce)(const char *, std::size_t) noexcept;
+  const char *name;
+};
+
+inline Kernels select() noexcept {
+#ifdef CNMEA_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return {classify_avx2, xor_avx2, "avx2"};
+  }
+  return {classify_sse2, xor_sse2, "sse2"};
+#else
+  return {classify_scalar, xor_scalar, "scalar"};
+#endif
+}
+
+/// Selected on first use, so calls made during static initialization are
+/// safe.
+inline const Kernels &kernels() noexcept {
+  static const Kernels selected = select();
+  return selected;
+}
+
+} // namespace detail
+
+/// @brief Name of the kernel set in use: "avx2", "sse2" or "scalar".
+inline std::string_view kernel_name() noexcept {
+  return detail::kernels().name;
+}
+
+/// @brief Classifies the 64 bytes at @p data, which must all be readable.
+inline Block classify(const char *data) noexcept {
+  return detail::kernels().classify(data);
+}
+
+/// @brief Classifies the first 64 bytes of @p data; a shorter view is
+/// zero-padded, so nothing past its end is read.
+inline Block classify(std::string_view data) noexcept {
+  if (data.size() >= BLOCK) {
+    return classify(data.data());
+  }
+  char padded[BLOCK]{};
+  std::memcpy(padded, data.data(), data.size());
+  return classify(padded);
+}
+
+/// @brief XOR of every byte of @p data, i.e. the NMEA checksum of a body.
+inline std::uint8_t xor_reduce(std::string_view data) noexcept {
+  return detail::kernels().xor_reduce(data.data(), data.size());
+}
+
+/// @brief Classifies @p data block by block, calling `block_handler(offset,
+/// Block)` for each. The last partial block is zero-padded.
+template <typename BlockHandler>
+void for_each_block(std::string_view data, BlockHandler &&block_handler) {
+  std::size_t offset = 0;
+
+  for (; offset + BLOCK <= data.size(); offset += BLOCK) {
+    block_handler(offset, classify(data.data() + offset));
+  }
+
+  if (offset < data.size()) {
+    block_handler(offset, classify(data.substr(offset)));
+  }
+}
+
+/// @brief Calls `callback(position)` for every bit set in @p mask, lowest
+/// first, offset by @p base.
+template <typename Callback>
+void for_each_bit(std::uint64_t mask, std::size_t base, Callback &&callback) {
+  while (mask != 0) {
+    callback(base + static_cast<std::size_t>(std::countr_zero(mask)));
+    mask &= mask - 1;
+  }
+}
+
+} // namespace cnmea::simd
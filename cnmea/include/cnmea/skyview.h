@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <string_view>
+
+#include "decode.h"
+#include "gsv.h"
+#include "tools.h"
+#include "types.h"
+
+namespace cnmea {
+
+/// @brief All satellites reported by one complete GSV cycle of a talker.
+struct SkyView {
+  /// @brief NMEA 0183 allows at most 9 GSV sentences of 4 satellites.
+  static constexpr std::size_t CAPACITY{36};
+
+  types::Talker talker{types::Talker::Unknown};
+  int satellites_in_view{0}; ///< As announced by the receiver
+  std::size_t count{0};      ///< Satellites stored in `satellites`
+  std::array<types::Satellite, CAPACITY> satellites{};
+
+  /// @brief The stored satellites.
+  std::span<const types::Satellite> view() const noexcept {
+    return {satellites.data(), count};
+  }
+};
+
+/// @brief Assembles multi-part GSV cycles into one SkyView per talker.
+///
+/// Each talker has its own preallocated SkyView that fragments are written
+/// into directly, so nothing is allocated per fragment. A cycle is complete
+/// when its last fragment arrives in sequence; the finished SkyView is then
+/// returned and stays valid until the next fragment of the same talker. A
+/// fragment out of sequence drops the cycle in progress, which costs nothing
+/// beyond resetting a counter.
+///
+/// Example:
+/// @code
+/// cnmea::SkyViewAssembler assembler;
+///
+/// for (std::string_view line : lines) {
+///   if (auto sky = assembler.push(line); sky && *sky) {
+///     plot((*sky)->talker, (*sky)->view());
+///   }
+/// }
+/// @endcode
+class SkyViewAssembler {
+public:
+  /// @brief Adds a parsed fragment.
+  /// @return The completed SkyView, or nullptr while the cycle is open.
+  const SkyView *push(const gsv::GSV &gsv) noexcept {
+    Cycle *cycle = begin(gsv.talker, gsv.total_messages, gsv.message_number,
+                         gsv.satellites_in_view);
+    if (cycle == nullptr) {
+      return nullptr;
+    }
+
+    for (const types::Satellite &satellite : gsv.satellites) {
+      add(*cycle, satellite);
+    }
+
+    return end(*cycle);
+  }
+
+  /// @brief Adds a fragment straight from its fields, without building a
+  /// gsv::GSV and its satellite vector.
+  const SkyView *push(const types::Header &header,
+                      const tools::Tokens &tokens) noexcept {
+    if (header.type != types::Type::GSV || tokens.size() < gsv::MIN_FIELDS) {
+      return nullptr;
+    }
+
+    Cycle *cycle =
+        begin(header.talker, decode::integer<int>(tokens[1]).value_or(0),
+              decode::integer<int>(tokens[2]).value_or(0),
+              decode::integer<int>(tokens[3]).value_or(0));
+    if (cycle == nullptr) {
+      return nullptr;
+    }
+
+    // Like gsv::parse, at most MAX_SATELLITES groups per fragment.
+    const std::size_t last = std::min<std::size_t>(
+        tokens.size(), 4 + 4 * gsv::MAX_SATELLITES);
+    for (std::size_t i = 4; i + 3 < last; i += 4) {
+      auto satellite = tools::parse_satellite(tokens[i], tokens[i + 1],
+                                              tokens[i + 2], tokens[i + 3]);
+      if (satellite) {
+        add(*cycle, satellite.value());
+      }
+    }
+
+    return end(*cycle);
+  }
+
+  /// @brief Parses and adds a GSV sentence without allocating.
+  /// @return The completed SkyView, nullptr while the cycle is open, or the
+  /// parse error.
+  std::expected<const SkyView *, types::ParseError>
+  push(std::string_view sample) noexcept {
+    auto header = tools::parse_header(sample);
+
+    if (!header || header->type != types::Type::GSV) {
+      return std::unexpected(types::ParseError::UnsupportedType);
+    }
+
+    auto sentence = tools::scan(sample);
+
+    if (!sentence) {
+      return std::unexpected(sentence.error());
+    }
+
+    return push(header.value(), sentence->tokens);
+  }
+
+  /// @brief Drops every cycle in progress.
+  void reset() noexcept {
+    for (Cycle &cycle : cycles) {
+      cycle.next = 0;
+      cycle.skipped = 0;
+    }
+  }
+
+  /// @brief Number of cycles dropped because a fragment was missing or out
+  /// of sequence, including cycles whose first fragment never arrived. Each
+  /// counts once, however many of its fragments go by.
+  std::size_t discarded_cycles() const noexcept { return discarded; }
+
+private:
+  static constexpr std::size_t TALKERS{
+      static_cast<std::size_t>(types::Talker::Unknown) + 1};
+
+  struct Cycle {
+    int total{0};
+    int next{0};    ///< Expected message number; 0 when no cycle is open
+    int skipped{0}; ///< Last message number of a dropped cycle, or 0
+    SkyView sky{};
+  };
+
+  std::array<Cycle, TALKERS> cycles{};
+  std::size_t discarded{0};
+
+  Cycle *begin(types::Talker talker, int total, int number,
+               int satellites_in_view) noexcept {
+    Cycle &cycle = cycles[static_cast<std::size_t>(talker)];
+
+    if (total < 1 || number < 1 || number > total) {
+      return nullptr;
+    }
+
+    if (number == 1) {
+      if (cycle.next != 0) {
+        discarded++;
+      }
+      cycle.total = total;
+      cycle.next = 1;
+      cycle.skipped = 0;
+      cycle.sky.talker = talker;
+      cycle.sky.satellites_in_view = satellites_in_view;
+      cycle.sky.count = 0;
+    }
+
+    if (cycle.next == 0 || number != cycle.next || total != cycle.total) {
+      // A cycle broken here or seen without its head; later fragments of
+      // the same dropped cycle have higher numbers.
+      if (cycle.next != 0 || cycle.skipped == 0 || number <= cycle.skipped) {
+        discarded++;
+      }
+      cycle.next = 0;
+      cycle.skipped = number;
+      return nullptr;
+    }
+
+    cycle.next++;
+    return &cycle;
+  }
+
+  static void add(Cycle &cycle, const types::Satellite &satellite) noexcept {
+    if (cycle.sky.count < SkyView::CAPACITY) {
+      cycle.sky.satellites[cycle.sky.count++] = satellite;
+    }
+  }
+
+  static const SkyView *end(Cycle &cycle) noexcept {
+    if (cycle.next <= cycle.total) {
+      return nullptr;
+    }
+    cycle.next = 0;
+    return &cycle.sky;
+  }
+};
+
+} // namespace cnmea
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+#include <utility>
+
+#include "cnmea.h"
+#include "filter.h"
+#include "types.h"
+
+namespace cnmea {
+
+/// @brief Frames and parses sentences from arbitrary byte chunks.
+///
+/// Chunks may split sentences anywhere. A sentence starts at `$` or `!` and
+/// ends at CR, LF or the start of the next sentence. Sentences that lie
+/// entirely inside a chunk are parsed in place; only the unfinished tail of
+/// a chunk is kept, in a fixed internal buffer, until the rest arrives. Memory
+/// use is bounded and nothing is allocated per sentence. A sentence longer
+/// than CAPACITY is reported as BufferOverflow however it was chunked.
+///
+/// Example:
+/// @code
+/// cnmea::StreamParser parser;
+///
+/// while (auto n = read(fd, data, sizeof(data))) {
+///   parser.feed({data, static_cast<size_t>(n)}, [](const auto &result) {
+///     if (result) {
+///       cnmea::print(result.value());
+///     }
+///   });
+/// }
+/// @endcode
+class StreamParser {
+public:
+  /// @brief Longest partial sentence kept between chunks. Generous compared
+  /// to the 82 characters allowed by NMEA 0183, for chatty receivers.
+  static constexpr std::size_t CAPACITY{256};
+
+  /// @brief Creates a parser whose results allocate from @p resource.
+  explicit StreamParser(std::pmr::memory_resource *resource =
+                            std::pmr::get_default_resource()) noexcept
+      : resource(resource) {}
+
+  /// @brief Creates a parser that only reports sentences accepted by
+  /// @p filter; the rest are dropped before validation.
+  explicit StreamParser(Filter filter,
+                        std::pmr::memory_resource *resource =
+                            std::pmr::get_default_resource()) noexcept
+      : resource(resource), filter(std::move(filter)) {}
+
+  /// @brief Consumes a chunk, calling @p handler with each parse result.
+  ///
+  /// The handler is invoked as `handler(const Result &)`.
+  template <typename Handler>
+  void feed(std::string_view chunk, Handler &&handler) {
+    while (!chunk.empty()) {
+      if (discarding) {
+        std::size_t next = chunk.find_first_of(DELIMITERS);
+        if (next == std::string_view::npos) {
+          discarded += chunk.size();
+          return;
+        }
+        discarded += next;
+        chunk.remove_prefix(next);
+        discarding = false;
+      }
+
+      if (length == 0) {
+        std::size_t start = chunk.find_first_of(STARTS);
+        if (start == std::string_view::npos) {
+          discarded += chunk.size();
+          return;
+        }
+        discarded += start;
+        chunk.remove_prefix(start);
+
+        std::size_t end = chunk.find_first_of(DELIMITERS, 1);
+        if (end != std::string_view::npos) {
+          // Complete sentence inside the chunk: parse it in place, unless
+          // it could not have been buffered.
+          if (end > CAPACITY) {
+            handler(Result{std::unexpected(types::ParseError::BufferOverflow)});
+            discarded += end;
+          } else {
+            emit(chunk.substr(0, end), handler);
+          }
+          chunk.remove_prefix(end);
+          continue;
+        }
+      }
+
+      std::size_t end = chunk.find_first_of(DELIMITERS, length == 0 ? 1 : 0);
+      std::size_t take = std::min(end, chunk.size());
+
+      if (length + take > CAPACITY) {
+        handler(Result{std::unexpected(types::ParseError::BufferOverflow)});
+        discarded += length + take;
+        length = 0;
+        discarding = true;
+        chunk.remove_prefix(take);
+        continue;
+      }
+
+      std::copy_n(chunk.data(), take, buffer.data() + length);
+      length += take;
+      chunk.remove_prefix(take);
+
+      if (end != std::string_view::npos) {
+        emit(std::string_view{buffer.data(), length}, handler);
+        length = 0;
+      }
+    }
+  }
+
+  /// @brief Parses a buffered partial sentence, e.g. at end of input.
+  template <typename Handler> void flush(Handler &&handler) {
+    if (length > 0) {
+      emit(std::string_view{buffer.data(), length}, handler);
+      length = 0;
+    }
+  }
+
+  /// @brief Drops any buffered partial sentence.
+  void reset() noexcept {
+    length = 0;
+    discarding = false;
+  }
+
+  /// @brief Number of bytes currently buffered.
+  std::size_t pending() const noexcept { return length; }
+
+  /// @brief Number of bytes skipped outside of any sentence, line
+  /// terminators included.
+  std::size_t discarded_bytes() const noexcept { return discarded; }
+
+  /// @brief Number of complete sentences rejected by the filter.
+  std::size_t filtered_sentences() const noexcept { return filtered; }
+
+private:
+  static constexpr std::string_view STARTS{"$!"};
+  static constexpr std::string_view DELIMITERS{"\r\n$!"};
+
+  std::pmr::memory_resource *resource;
+  Filter filter;
+  std::array<char, CAPACITY> buffer{};
+  std::size_t length{0};
+  std::size_t discarded{0};
+  std::size_t filtered{0};
+  bool discarding{false};
+
+  template <typename Handler>
+  void emit(std::string_view sentence, Handler &handler) {
+    if (!filter.accepts(sentence)) {
+      filtered++;
+      return;
+    }
+    handler(parse(sentence, resource));
+  }
+};
+
+} // namespace cnmea
@@ -1,94 +1,282 @@
 #pragma once
 
+#include <array>
+#include <bit>
+#include <cstdint>
 #include <expected>
-#include <iomanip>
-#include <iostream>
+#include <limits>
+#include <optional>
 #include <print>
-#include <sstream>
 #include <string_view>
-#include <vector>
 
+#include "decode.h"
+#include "simd.h"
 #include "types.h"
 
 namespace cnmea::tools {
 
-inline std::vector<std::string_view> split(const std::string_view sample,
-                                           char separator) {
+/// @brief Maximum length of an NMEA 0183 sentence, including `$` and CR/LF.
+constexpr std::size_t MAX_SENTENCE_LENGTH{82};
+
+/// @brief Upper bound on the number of fields in a sentence. Once the
+/// `$ttSSS` header and the `*hh\r\n` trailer are removed, 71 characters are
+/// left, so a well-formed sentence can never hold more than 72 fields.
+constexpr std::size_t MAX_FIELDS{72};
+
+/// @brief Field list of a tokenized sentence; index 0 is the `$ttSSS` header.
+///
+/// Fields are stored in a fixed-capacity array, so tokenizing a sentence never
+/// allocates. The views point into the original sample.
+class Tokens {
+private:
+  std::array<std::string_view, MAX_FIELDS> fields{};
+  std::size_t count{0};
+
+public:
+  /// @brief Appends a field, returning false when the capacity is exhausted.
+  bool push_back(std::string_view field) noexcept {
+    if (count == fields.size()) {
+      return false;
+    }
+    fields[count++] = field;
+    return true;
+  }
+
+  std::size_t size() const noexcept { return count; }
+  bool empty() const noexcept { return count == 0; }
+
+  std::string_view operator[](std::size_t index) const noexcept {
+    return fields[index];
+  }
+
+  /// @brief Returns the field at @p index, or an empty view past the end.
+  /// Used for trailing fields that older NMEA versions omit.
+  std::string_view get(std::size_t index) const noexcept {
+    return index < count ? fields[index] : std::string_view{};
+  }
+
+  auto begin() const noexcept { return fields.begin(); }
+  auto end() const noexcept { return fields.begin() + count; }
+};
+
+/// @brief Packs a three-character sentence formatter into a switchable code.
+constexpr std::uint32_t formatter_code(char a, char b, char c) noexcept {
+  return (static_cast<std::uint32_t>(static_cast<unsigned char>(a)) << 16) |
+         (static_cast<std::uint32_t>(static_cast<unsigned char>(b)) << 8) |
+         static_cast<std::uint32_t>(static_cast<unsigned char>(c));
+}
+
+constexpr std::uint32_t formatter_code(std::string_view formatter) noexcept {
+  return formatter_code(formatter[0], formatter[1], formatter[2]);
+}
+
+inline types::Talker parse_talker(char a, char b) noexcept {
+  using enum types::Talker;
+  if (a == 'G') {
+    switch (b) {
+    case 'P':
+      return GP;
+    case 'L':
+      return GL;
+    case 'A':
+      return GA;
+    case 'B':
+      return GB;
+    case 'Q':
+      return GQ;
+    case 'I':
+      return GI;
+    case 'N':
+      return GN;
+    }
+  } else if (a == 'B' && b == 'D') {
+    return GB;
+  }
+  return Unknown;
+}
+
+/// @brief Decodes the `$ttSSS` header by fixed position.
+///
+/// Only the first six characters are inspected, so a formatter appearing
+/// anywhere in the payload can never select the wrong parser. The leading
+/// `$` (or `!`) is optional.
+inline std::expected<types::Header, types::ParseError>
+parse_header(std::string_view sample) noexcept {
+  if (!sample.empty() && (sample.front() == '$' || sample.front() == '!')) {
+    sample.remove_prefix(1);
+  }
+
+  if (sample.size() < 5 || (sample.size() > 5 && sample[5] != ',' &&
+                            sample[5] != '*')) {
+    return std::unexpected(types::ParseError::UnsupportedType);
+  }
+
+  types::Talker talker = parse_talker(sample[0], sample[1]);
+
+  using enum types::Type;
+  switch (formatter_code(sample.substr(2, 3))) {
+  case formatter_code("GGA"):
+    return types::Header{talker, GGA};
+  case formatter_code("GLL"):
+    return types::Header{talker, GLL};
+  case formatter_code("GSA"):
+    return types::Header{talker, GSA};
+  case formatter_code("GSV"):
+    return types::Header{talker, GSV};
+  case formatter_code("RMC"):
+    return types::Header{talker, RMC};
+  case formatter_code("VTG"):
+    return types::Header{talker, VTG};
+  case formatter_code("ZDA"):
+    return types::Header{talker, ZDA};
+  }
+
+  return std::unexpected(types::ParseError::UnsupportedType);
+}
+
+inline std::expected<Tokens, types::ParseError>
+split(const std::string_view sample, char separator) noexcept {
   size_t start = 0;
   size_t end = 0;
 
-  std::vector<std::string_view> tokens;
+  Tokens tokens;
 
   while ((end = sample.find(separator, start)) != std::string::npos) {
-    tokens.push_back(sample.substr(start, end - start));
+    if (!tokens.push_back(sample.substr(start, end - start))) {
+      return std::unexpected(types::ParseError::TooManyFields);
+    }
     start = end + 1;
   }
 
-  tokens.push_back(sample.substr(start));
+  if (!tokens.push_back(sample.substr(start))) {
+    return std::unexpected(types::ParseError::TooManyFields);
+  }
 
   return tokens;
 }
 
-inline bool is_valid_sample(const std::string_view sample) {
-  std::vector<std::string_view> tokens{split(sample, '*')};
+/// @brief Hexadecimal digit values, -1 for any other character.
+constexpr std::array<std::int8_t, 256> HEX_DIGITS = [] {
+  std::array<std::int8_t, 256> table{};
+  table.fill(-1);
+  for (int i = 0; i < 10; i++) {
+    table['0' + i] = static_cast<std::int8_t>(i);
+  }
+  for (int i = 0; i < 6; i++) {
+    table['A' + i] = static_cast<std::int8_t>(10 + i);
+    table['a' + i] = static_cast<std::int8_t>(10 + i);
+  }
+  return table;
+}();
+
+/// @brief A sentence whose checksum has been verified, with its fields located.
+struct Sentence {
+  std::string_view body; ///< Characters between `$` and `*`
+  Tokens tokens;         ///< Comma separated fields of the body
+  std::uint8_t checksum; ///< Checksum carried by (and matching) the sentence
+};
+
+/// @brief Validates and tokenizes a sentence in a single pass.
+///
+/// The sentence is classified 64 bytes at a time by the simd kernels: comma
+/// positions become token boundaries and the first `*` ends the body, which
+/// is then XOR-reduced in vector-wide steps. The two trailing hex digits are
+/// decoded with a lookup table. A trailing CR/LF is accepted.
+inline std::expected<Sentence, types::ParseError>
+scan(const std::string_view sample) noexcept {
+  size_t begin =
+      !sample.empty() && (sample.front() == '$' || sample.front() == '!') ? 1
+                                                                          : 0;
+
+  Sentence sentence{};
+  size_t start = 0;
+  size_t end = std::string_view::npos;
+
+  for (size_t offset = 0;
+       offset < sample.size() && end == std::string_view::npos;
+       offset += simd::BLOCK) {
+    simd::Block block = simd::classify(sample.substr(offset));
+    std::uint64_t commas = block.comma;
+
+    if (block.star != 0) {
+      int star = std::countr_zero(block.star);
+      end = offset + static_cast<size_t>(star);
+      commas &= (std::uint64_t{1} << star) - 1;
+    }
+
+    for (; commas != 0; commas &= commas - 1) {
+      size_t comma = offset + static_cast<size_t>(std::countr_zero(commas));
+      if (!sentence.tokens.push_back(sample.substr(start, comma - start))) {
+        return std::unexpected(types::ParseError::TooManyFields);
+      }
+      start = comma + 1;
+    }
+  }
 
-  if (tokens.size() < 2 || tokens.at(1).empty()) {
-    return false;
+  if (end == std::string_view::npos) {
+    return std::unexpected(types::ParseError::InvalidFormat);
   }
 
-  std::string_view sentence = tokens.at(0);
+  std::uint8_t check = simd::xor_reduce(sample.substr(begin, end - begin));
 
-  if (sentence.starts_with('$')) {
-    sentence.remove_prefix(1);
+  if (end + 2 >= sample.size() ||
+      sample.find_first_not_of("\r\n", end + 3) != std::string::npos) {
+    return std::unexpected(types::ParseError::InvalidFormat);
   }
 
-  unsigned char check = 0;
+  int high = HEX_DIGITS[static_cast<unsigned char>(sample[end + 1])];
+  int low = HEX_DIGITS[static_cast<unsigned char>(sample[end + 2])];
 
-  for (char c : sentence) {
-    check ^= static_cast<unsigned char>(c);
+  if (high < 0 || low < 0) {
+    return std::unexpected(types::ParseError::InvalidFormat);
   }
 
-  std::stringstream hex_check;
+  if (((high << 4) | low) != check) {
+    return std::unexpected(types::ParseError::InvalidChecksum);
+  }
+
+  if (!sentence.tokens.push_back(sample.substr(start, end - start))) {
+    return std::unexpected(types::ParseError::TooManyFields);
+  }
 
-  hex_check << std::uppercase << std::hex << std::setfill('0') << std::setw(2)
-            << static_cast<int>(check);
+  sentence.body = sample.substr(begin, end - begin);
+  sentence.checksum = check;
 
-  return hex_check.str() == tokens.at(1);
+  return sentence;
 }
 
-inline std::vector<std::string_view> tokenize(const std::string_view sample) {
-  std::vector<std::string_view> raw_data = split(sample, '*');
-  return split(raw_data.at(0), ',');
+inline bool is_valid_sample(const std::string_view sample) noexcept {
+  return scan(sample).has_value();
+}
+
+inline std::expected<Tokens, types::ParseError>
+tokenize(const std::string_view sample) noexcept {
+  return split(sample.substr(0, sample.find('*')), ',');
 }
 
 inline std::expected<double, types::ParseError>
-parse_numeric_value(const std::string_view token) {
-  try {
-    return std::stod(std::string{token});
-  } catch (...) {
-    return std::unexpected(types::ParseError::MissingFields);
-  }
+parse_numeric_value(const std::string_view token) noexcept {
+  return decode::fixed_decimal(token);
 }
 
+/// @brief Decodes a DDMM.mmmm coordinate field into decimal degrees.
 inline std::expected<double, types::ParseError>
-parse_coordinate(const std::string_view token) {
-  try {
-    return std::stod(std::string{token}) / 100.0;
-  } catch (...) {
-    return std::unexpected(types::ParseError::MissingFields);
-  }
+parse_coordinate(const std::string_view token) noexcept {
+  return decode::coordinate(token);
 }
 
-inline auto parse_utc_time(std::string_view utc_time) {
-  return types::UTCTime{
-      std::string_view{utc_time.substr(0, 2)},
-      std::string_view{utc_time.substr(2, 2)},
-      std::string_view{utc_time.substr(4, 2)},
-  };
+/// @brief Decodes an hhmmss.ss time field; empty or malformed is nullopt.
+inline std::optional<types::UTCTime>
+parse_utc_time(std::string_view utc_time) noexcept {
+  auto time = decode::utc_time(utc_time);
+  if (time.has_value()) {
+    return time.value();
+  }
+  return std::nullopt;
 }
 
 inline std::expected<types::Direction, types::ParseError>
-parse_latitude_direction(std::string_view token) {
+parse_latitude_direction(std::string_view token) noexcept {
   if (token == "N" || token == "S") {
     return token.front() == 'N' ? types::Direction::North
                                 : types::Direction::South;
@@ -97,7 +285,7 @@ parse_latitude_direction(std::string_view token) {
 }
 
 inline std::expected<types::Direction, types::ParseError>
-parse_longitude_direction(std::string_view token) {
+parse_longitude_direction(std::string_view token) noexcept {
   if (!token.empty() && (token == "E" || token == "W")) {
     return token.front() == 'E' ? types::Direction::East
                                 : types::Direction::West;
@@ -105,20 +293,19 @@ parse_longitude_direction(std::string_view token) {
   return std::unexpected(types::ParseError::InvalidDirection);
 }
 
-inline types::Status parse_status(std::string_view status) {
+inline std::expected<types::Status, types::ParseError>
+parse_status(std::string_view status) noexcept {
   using enum types::Status;
-  switch (status.front()) {
-  case 'A':
+  if (status == "A") {
     return Valid;
-  case 'V':
+  } else if (status == "V") {
     return Invalid;
-  default:
-    throw std::invalid_argument("Unknown type");
   }
+  return std::unexpected(types::ParseError::InvalidStatus);
 }
 
 inline std::optional<types::Latitude>
-parse_latitude(std::string_view value, std::string_view direction) {
+parse_latitude(std::string_view value, std::string_view direction) noexcept {
   if (value.empty() || direction.empty()) {
     return std::nullopt;
   }
@@ -132,7 +319,7 @@ parse_latitude(std::string_view value, std::string_view direction) {
 }
 
 inline std::optional<types::Longitude>
-parse_longitude(std::string_view value, std::string_view direction) {
+parse_longitude(std::string_view value, std::string_view direction) noexcept {
   if (value.empty() || direction.empty()) {
     return std::nullopt;
   }
@@ -148,7 +335,7 @@ parse_longitude(std::string_view value, std::string_view direction) {
 
 inline std::optional<types::Speed>
 parse_speed(std::string_view speed,
-            types::SpeedUnits units = types::SpeedUnits::knots) {
+            types::SpeedUnits units = types::SpeedUnits::knots) noexcept {
   if (speed.empty()) {
     return std::nullopt;
   }
@@ -163,12 +350,12 @@ parse_speed(std::string_view speed,
     case kmh:
       return types::Speed(speed_value.value() * types::KNTOKMH, units);
     }
-  } else {
-    return std::nullopt;
   }
+  return std::nullopt;
 }
 
-inline std::optional<types::Course> parse_course(std::string_view course) {
+inline std::optional<types::Course>
+parse_course(std::string_view course) noexcept {
   if (course.empty()) {
     return std::nullopt;
   }
@@ -180,23 +367,23 @@ inline std::optional<types::Course> parse_course(std::string_view course) {
   }
 }
 
-inline std::optional<types::UTCDate> parse_utc_date(std::string_view utc_date) {
-  if (utc_date.empty() || utc_date.size() < 6) {
-    return std::nullopt;
+/// @brief Decodes a ddmmyy date field; empty or malformed is nullopt.
+inline std::optional<types::UTCDate>
+parse_utc_date(std::string_view utc_date) noexcept {
+  auto date = decode::utc_date(utc_date);
+  if (date.has_value()) {
+    return date.value();
   }
-  return types::UTCDate{
-      std::string_view{utc_date.substr(0, 2)},
-      std::string_view{utc_date.substr(2, 2)},
-      std::string_view{utc_date.substr(4, 2)},
-  };
-};
+  return std::nullopt;
+}
 
 inline std::optional<types::MagneticVariation>
-parse_magnetic_variation(std::string_view value, std::string_view direction) {
+parse_magnetic_variation(std::string_view value,
+                         std::string_view direction) noexcept {
   if (value.empty() || direction.empty()) {
     return std::nullopt;
   }
-  auto magnetic_variation_value = parse_coordinate(value);
+  auto magnetic_variation_value = parse_numeric_value(value);
   auto magnetic_variation_direction = parse_longitude_direction(direction);
   if (magnetic_variation_value.has_value() &&
       magnetic_variation_direction.has_value()) {
@@ -207,7 +394,7 @@ parse_magnetic_variation(std::string_view value, std::string_view direction) {
   }
 }
 
-inline std::optional<types::Mode> parse_mode(std::string_view mode) {
+inline std::optional<types::Mode> parse_mode(std::string_view mode) noexcept {
   if (mode.empty()) {
     return std::nullopt;
   }
@@ -227,28 +414,16 @@ inline std::optional<types::Mode> parse_mode(std::string_view mode) {
   }
 }
 
-inline types::Type parse_type(std::string_view type) {
-  using enum types::Type;
-  if (type.contains("GGA")) {
-    return GGA;
-  } else if (type.contains("RMC")) {
-    return RMC;
-  } else if (type.contains("GLL")) {
-    return GLL;
-  } else if (type.contains("GSA")) {
-    return GSA;
-  } else if (type.contains("GSV")) {
-    return GSV;
-  } else if (type.contains("VTG")) {
-    return VTG;
-  } else if (type.contains("ZDA")) {
-    return ZDA;
-  }
-  throw std::invalid_argument("Unknown type");
+inline std::expected<types::Type, types::ParseError>
+parse_type(std::string_view type) noexcept {
+  if (auto header = parse_header(type)) {
+    return header->type;
+  }
+  return std::unexpected(types::ParseError::UnsupportedType);
 }
 
 inline std::expected<types::DistanceUnits, types::ParseError>
-parse_distance_units(std::string_view distance_units) {
+parse_distance_units(std::string_view distance_units) noexcept {
   using enum types::DistanceUnits;
   if (distance_units == "M") {
     return m;
@@ -260,33 +435,17 @@ parse_distance_units(std::string_view distance_units) {
   return std::unexpected(types::ParseError::UnsupportedType);
 }
 
-inline types::FixQuality parse_fix_quality(std::string_view fix_quality) {
-  using enum types::FixQuality;
-  if (fix_quality == "0") {
-    return Invalid;
-  } else if (fix_quality == "1") {
-    return GPS;
-  } else if (fix_quality == "2") {
-    return DGPS;
-  } else if (fix_quality == "3") {
-    return PPS;
-  } else if (fix_quality == "4") {
-    return RealTimeKinematic;
-  } else if (fix_quality == "5") {
-    return FloatRTK;
-  } else if (fix_quality == "6") {
-    return Estimated;
-  } else if (fix_quality == "7") {
-    return ManualInput;
-  } else if (fix_quality == "8") {
-    return Simulation;
+inline std::expected<types::FixQuality, types::ParseError>
+parse_fix_quality(std::string_view fix_quality) noexcept {
+  if (fix_quality.size() != 1 || fix_quality.front() < '0' ||
+      fix_quality.front() > '8') {
+    return std::unexpected(types::ParseError::InvalidFixQuality);
   }
-
-  throw std::invalid_argument("Unknown type");
+  return static_cast<types::FixQuality>(fix_quality.front() - '0');
 }
 
-inline std::optional<types::Altitude> parse_altitude(std::string_view altitude,
-                                                     std::string_view units) {
+inline std::optional<types::Altitude>
+parse_altitude(std::string_view altitude, std::string_view units) noexcept {
   if (altitude.empty() || units.empty()) {
     return std::nullopt;
   }
@@ -301,7 +460,7 @@ inline std::optional<types::Altitude> parse_altitude(std::string_view altitude,
 
 inline std::optional<types::GeoidSeparation>
 parse_geoid_separation(std::string_view geoid_separation,
-                       std::string_view units) {
+                       std::string_view units) noexcept {
   if (geoid_separation.empty() || units.empty()) {
     return std::nullopt;
   }
@@ -317,7 +476,7 @@ parse_geoid_separation(std::string_view geoid_separation,
 }
 
 inline std::optional<types::AgeOfDgps>
-parse_age_of_dgps(std::string_view age_of_dgps) {
+parse_age_of_dgps(std::string_view age_of_dgps) noexcept {
   if (age_of_dgps.empty()) {
     return std::nullopt;
   }
@@ -330,30 +489,30 @@ parse_age_of_dgps(std::string_view age_of_dgps) {
 }
 
 inline std::optional<types::DgpsStationId>
-parse_dgps_station_id(std::string_view dgps_station_id) {
+parse_dgps_station_id(std::string_view dgps_station_id) noexcept {
   if (dgps_station_id.empty()) {
     return std::nullopt;
   }
-  auto dgps_station_id_value = tools::parse_numeric_value(dgps_station_id);
+  auto dgps_station_id_value = decode::integer<int>(dgps_station_id);
   if (dgps_station_id_value.has_value()) {
-    return types::DgpsStationId(
-        static_cast<int>(dgps_station_id_value.value()));
+    return types::DgpsStationId(dgps_station_id_value.value());
   } else {
     return std::nullopt;
   }
 }
 
-inline types::SelectionMode
-parse_selection_mode(std::string_view selection_mode) {
+inline std::expected<types::SelectionMode, types::ParseError>
+parse_selection_mode(std::string_view selection_mode) noexcept {
   if (selection_mode == "M") {
     return types::SelectionMode::Manual;
   } else if (selection_mode == "A") {
     return types::SelectionMode::Automatic;
   }
-  throw std::invalid_argument("Unknown type");
+  return std::unexpected(types::ParseError::InvalidSelectionMode);
 }
 
-inline types::FixType parse_fix_type(std::string_view fix_type) {
+inline std::expected<types::FixType, types::ParseError>
+parse_fix_type(std::string_view fix_type) noexcept {
   using enum types::FixType;
   if (fix_type == "1") {
     return None;
@@ -362,11 +521,12 @@ inline types::FixType parse_fix_type(std::string_view fix_type) {
   } else if (fix_type == "3") {
     return ThreeD;
   }
-  throw std::invalid_argument("Unknown type");
+  return std::unexpected(types::ParseError::InvalidFixType);
 }
 
-inline std::optional<types::DOP>
-parse_dop(std::string_view pdop, std::string_view hdop, std::string_view vdop) {
+inline std::optional<types::DOP> parse_dop(std::string_view pdop,
+                                           std::string_view hdop,
+                                           std::string_view vdop) noexcept {
   if (pdop.empty() || hdop.empty() || vdop.empty()) {
     return std::nullopt;
   }
@@ -386,12 +546,13 @@ parse_dop(std::string_view pdop, std::string_view hdop, std::string_view vdop) {
 
 inline std::optional<types::Satellite>
 parse_satellite(std::string_view prn, std::string_view snr,
-                std::string_view elevation, std::string_view azimuth) {
+                std::string_view elevation,
+                std::string_view azimuth) noexcept {
   if (prn.empty()) {
     return std::nullopt;
   }
 
-  auto prn_value = tools::parse_numeric_value(prn);
+  auto prn_value = decode::integer<int>(prn);
   auto snr_value = tools::parse_numeric_value(snr).value_or(
       std::numeric_limits<double>::quiet_NaN());
   auto elevation_value = tools::parse_numeric_value(elevation).value_or(
@@ -400,8 +561,8 @@ parse_satellite(std::string_view prn, std::string_view snr,
       std::numeric_limits<double>::quiet_NaN());
 
   if (prn_value.has_value()) {
-    return types::Satellite{static_cast<int>(prn_value.value()), snr_value,
-                            elevation_value, azimuth_value};
+    return types::Satellite{prn_value.value(), snr_value, elevation_value,
+                            azimuth_value};
   } else {
     return std::nullopt;
   }
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <numbers>
-#include <string_view>
 #include <variant>
 
 /**
@@ -45,6 +48,9 @@ constexpr double KNTOMS{0.514444444};
 /** @brief Conversion factor: knots to kilometers per hour */
 constexpr double KNTOKMH{1.85};
 
+/** @brief Conversion factor: feet to meters */
+constexpr double FTTOM{0.3048};
+
 /** @} */ // end of Units Conversion and Constants
 
 /**
@@ -65,8 +71,20 @@ enum class ParseError {
   InvalidUTCDate,           ///< UTC date value invalid
   InvalidUTCTime,           ///< UTC time value invalid
   InvalidMagneticVariation, ///< Magnetic variation value invalid
-  InvalidMode               ///< Mode value invalid
+  InvalidMode,              ///< Mode value invalid
+  TooManyFields,            ///< Sentence exceeds the field capacity
+  InvalidChecksum,          ///< Checksum does not match the sentence
+  InvalidStatus,            ///< Status value invalid
+  InvalidFixQuality,        ///< Fix quality value invalid
+  InvalidSelectionMode,     ///< Selection mode value invalid
+  InvalidFixType,           ///< Fix type value invalid
+  BufferOverflow,           ///< Sentence too long for the framing buffer
+  IOError                   ///< Input could not be opened or read
 };
+
+/// @brief Number of ParseError values, for tables indexed by error.
+constexpr std::size_t PARSE_ERRORS{
+    static_cast<std::size_t>(ParseError::IOError) + 1};
 /** @} */ // end of Errors
 
 /**
@@ -92,6 +110,8 @@ public:
   double value_radians() const {
     return value_degrees() * std::numbers::pi / 180.0;
   }
+
+  bool operator==(const Course &) const = default;
 };
 
 /**
@@ -117,6 +137,8 @@ public:
   double value_radians() const {
     return value_degrees() * std::numbers::pi / 180.0;
   }
+
+  bool operator==(const Latitude &) const = default;
 };
 
 /**
@@ -142,6 +164,8 @@ public:
   double value_radians() const {
     return value_degrees() * std::numbers::pi / 180.0;
   }
+
+  bool operator==(const Longitude &) const = default;
 };
 
 /** @} */ // end of Coordinates
@@ -164,26 +188,52 @@ public:
       : value(value), units(units) {}
   double get_value() const { return value; }
   SpeedUnits get_units() const { return units; }
+
+  bool operator==(const Speed &) const = default;
 };
 /** @} */
 
 /**
  * @defgroup TimeDate UTC Time and Date
+ * @brief Decoded, self-contained time and date fields.
  * @{
  * @example
- * UTCTime t{"12", "34", "56"};
- * UTCDate d{"23", "08", "2025"};
+ * UTCTime t{12, 34, 56, 500'000'000}; // 12:34:56.5
+ * auto since_midnight = t.to_duration();
+ * UTCDate d{23, 8, 2025};
+ * std::chrono::sys_days day = d.to_sys_days();
  */
 struct UTCTime {
-  std::string_view hours;   ///< Hours component
-  std::string_view minutes; ///< Minutes component
-  std::string_view seconds; ///< Seconds component
+  std::uint8_t hours{0};        ///< Hours component
+  std::uint8_t minutes{0};      ///< Minutes component
+  std::uint8_t seconds{0};      ///< Seconds component, 60 on a leap second
+  std::uint32_t nanoseconds{0}; ///< Sub-second component
+
+  /// @brief Time elapsed since midnight.
+  constexpr std::chrono::nanoseconds to_duration() const noexcept {
+    return std::chrono::hours{hours} + std::chrono::minutes{minutes} +
+           std::chrono::seconds{seconds} +
+           std::chrono::nanoseconds{nanoseconds};
+  }
+
+  constexpr bool operator==(const UTCTime &) const = default;
 };
 
 struct UTCDate {
-  std::string_view day;   ///< Day component
-  std::string_view month; ///< Month component
-  std::string_view year;  ///< Year component
+  std::uint8_t day{0};   ///< Day component
+  std::uint8_t month{0}; ///< Month component
+  std::uint16_t year{0}; ///< Full year, e.g. 2025
+
+  constexpr std::chrono::year_month_day to_year_month_day() const noexcept {
+    return std::chrono::year{year} / std::chrono::month{month} /
+           std::chrono::day{day};
+  }
+
+  constexpr std::chrono::sys_days to_sys_days() const noexcept {
+    return std::chrono::sys_days{to_year_month_day()};
+  }
+
+  constexpr bool operator==(const UTCDate &) const = default;
 };
 /** @} */
 
@@ -202,6 +252,32 @@ enum class Type {
 };
 /** @} */
 
+/**
+ * @defgroup TalkerData NMEA Talker Identifiers
+ * @{
+ */
+enum class Talker {
+  GP,     ///< GPS
+  GL,     ///< GLONASS
+  GA,     ///< Galileo
+  GB,     ///< BeiDou (also reported as "BD")
+  GQ,     ///< QZSS
+  GI,     ///< NavIC (IRNSS)
+  GN,     ///< Combined GNSS solution
+  Unknown ///< Any other talker identifier
+};
+
+/**
+ * @brief Decoded `$ttSSS` sentence header.
+ * @example
+ * Header h{Talker::GN, Type::GGA}; // "$GNGGA"
+ */
+struct Header {
+  Talker talker; ///< Two-character talker identifier
+  Type type;     ///< Three-character sentence formatter
+};
+/** @} */
+
 /**
  * @defgroup StatusData Status Indicators
  * @{
@@ -270,6 +346,8 @@ public:
   double value_radians() const {
     return value_degrees() * std::numbers::pi / 180.0;
   }
+
+  bool operator==(const MagneticVariation &) const = default;
 };
 /** @} */
 
@@ -293,6 +371,8 @@ public:
   DistanceUnits get_units() const { return units; }
   double value_meters() const { return value; }
   double value_feet() const { return value * 3.28084; }
+
+  bool operator==(const Altitude &) const = default;
 };
 
 struct GeoidSeparation {
@@ -307,6 +387,8 @@ public:
   DistanceUnits get_units() const { return units; }
   double value_meters() const { return value; }
   double value_feet() const { return value * 3.28084; }
+
+  bool operator==(const GeoidSeparation &) const = default;
 };
 /** @} */
 
@@ -325,6 +407,8 @@ public:
   explicit AgeOfDgps(double seconds) : seconds(seconds) {}
   double value_seconds() const { return seconds; }
   double value_minutes() const { return seconds / 60.0; }
+
+  bool operator==(const AgeOfDgps &) const = default;
 };
 
 struct DgpsStationId {
@@ -334,6 +418,8 @@ private:
 public:
   explicit DgpsStationId(int id) : id(id) {}
   int value() const { return id; }
+
+  bool operator==(const DgpsStationId &) const = default;
 };
 /** @} */
 
@@ -357,6 +443,8 @@ struct DOP {
   double pdop; ///< Position DOP
   double hdop; ///< Horizontal DOP
   double vdop; ///< Vertical DOP
+
+  bool operator==(const DOP &) const = default;
 };
 
 /**
@@ -367,6 +455,16 @@ struct Satellite {
   double elevation; ///< Elevation angle in degrees (0–90)
   double azimuth;   ///< Azimuth angle in degrees (0–359)
   double snr;       ///< Signal-to-Noise Ratio in dBHz (0–99)
+
+  /// @brief Fields missing on both sides (NaN) compare equal, so that a
+  /// parsed satellite equals itself.
+  bool operator==(const Satellite &other) const noexcept {
+    auto same = [](double a, double b) {
+      return a == b || (std::isnan(a) && std::isnan(b));
+    };
+    return prn == other.prn && same(elevation, other.elevation) &&
+           same(azimuth, other.azimuth) && same(snr, other.snr);
+  }
 };
 
 /**
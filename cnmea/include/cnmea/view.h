@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include "schema.h"
+#include "tools.h"
+#include "types.h"
+
+namespace cnmea {
+
+/// @brief A validated sentence whose fields are decoded on first access.
+///
+/// Creating a view checks the header, the checksum and the field count and
+/// records where each field lies; nothing else is decoded. get() decodes the
+/// entry of the requested member from its schema::Layout, caches it and
+/// returns the cached value on later calls. Consumers that read a few
+/// fields, e.g. position and fix quality of a GGA, skip the cost of the
+/// rest.
+///
+/// The view refers into the sentence it was created from, which must
+/// outlive it. It is not thread-safe: get() fills the cache even though it
+/// is const, so concurrent reads of one view race. Use one view per thread.
+///
+/// Example:
+/// @code
+/// if (auto view = cnmea::gga::view(sample)) {
+///   auto latitude = view->latitude();
+///   auto quality = view->fix_quality();
+/// }
+/// @endcode
+template <typename SentenceLayout> class SentenceView {
+public:
+  using Layout = SentenceLayout;
+  using Sentence = typename Layout::Output;
+
+  SentenceView(const types::Header &header, const tools::Tokens &tokens,
+               std::pmr::memory_resource *resource =
+                   std::pmr::get_default_resource()) noexcept
+      : fields(tokens), resource(resource) {
+    cache.type = header.type;
+    cache.talker = header.talker;
+  }
+
+  types::Type type() const noexcept { return cache.type; }
+  types::Talker talker() const noexcept { return cache.talker; }
+
+  /// @brief Raw field @p index, header included, or an empty view past
+  /// the end.
+  std::string_view field(std::size_t index) const noexcept {
+    return fields.get(index);
+  }
+
+  /// @brief Decodes @p Member on first use. Members whose decoder can
+  /// reject the sentence are returned as std::expected by value; all others
+  /// by reference to the cached value.
+  template <auto Member> decltype(auto) get() const noexcept {
+    constexpr std::size_t INDEX = Layout::template index_of<Member>();
+    static_assert(INDEX < ENTRIES, "member is not part of the layout");
+    using Entry = std::tuple_element_t<INDEX, typename Layout::Entries>;
+    constexpr std::uint64_t BIT = std::uint64_t{1} << INDEX;
+
+    if ((decoded & BIT) == 0) {
+      errors[INDEX] = Entry::decode(cache, fields, resource);
+      decoded |= BIT;
+    }
+
+    using Value = std::remove_cvref_t<decltype(cache.*Member)>;
+    if constexpr (Entry::FALLIBLE) {
+      if (errors[INDEX]) {
+        return std::expected<Value, types::ParseError>(
+            std::unexpect, errors[INDEX].value());
+      }
+      return std::expected<Value, types::ParseError>(cache.*Member);
+    } else {
+      return static_cast<const Value &>(cache.*Member);
+    }
+  }
+
+  /// @brief Decodes every field, as the per-type parse() does.
+  std::expected<Sentence, types::ParseError> decode() const noexcept {
+    return Layout::parse(types::Header{cache.talker, cache.type}, fields,
+                         resource);
+  }
+
+private:
+  static constexpr std::size_t ENTRIES{
+      std::tuple_size_v<typename Layout::Entries>};
+  static_assert(ENTRIES <= 64, "decoded entries are tracked in a bitmask");
+
+  tools::Tokens fields;
+  std::pmr::memory_resource *resource;
+  mutable Sentence cache{};
+  mutable std::uint64_t decoded{0};
+  mutable std::array<std::optional<types::ParseError>, ENTRIES> errors{};
+};
+
+/// @brief Validates @p sample as a sentence of @p View's layout and wraps
+/// its located fields without decoding them.
+template <typename View>
+std::expected<View, types::ParseError>
+make_view(std::string_view sample,
+          std::pmr::memory_resource *resource =
+              std::pmr::get_default_resource()) noexcept {
+  using Layout = typename View::Layout;
+  auto header = tools::parse_header(sample);
+
+  if (!header || header->type != Layout::SENTENCE_TYPE) {
+    return std::unexpected(types::ParseError::UnsupportedType);
+  }
+
+  auto sentence = tools::scan(sample);
+
+  if (!sentence) {
+    return std::unexpected(sentence.error());
+  }
+
+  if (sentence->tokens.size() < Layout::MIN_FIELDS) {
+    return std::unexpected(types::ParseError::MissingFields);
+  }
+
+  return std::expected<View, types::ParseError>(
+      std::in_place, header.value(), sentence->tokens, resource);
+}
+
+} // namespace cnmea
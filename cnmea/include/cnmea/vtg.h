@@ -4,43 +4,106 @@
 #include <optional>
 
 #include "p_tools.h"
+#include "schema.h"
+#include "serialize.h"
 #include "tools.h"
 #include "types.h"
+#include "view.h"
 
 namespace cnmea::vtg {
 
 struct VTG {
   types::Type type;
+  types::Talker talker;
   std::optional<types::Course> course_true;
   std::optional<types::Course> course_magnetic;
   std::optional<types::Speed> speed_knots;
   std::optional<types::Speed> speed_kmh;
   std::optional<types::Mode> mode;
+
+  bool operator==(const VTG &) const = default;
 };
 
-inline std::expected<VTG, types::ParseError> parse(std::string_view sample) {
-  if (!tools::is_valid_sample(sample)) {
-    return std::unexpected(types::ParseError::InvalidFormat);
+/// @brief Field layout; MIN_FIELDS and the parsers are generated from it.
+using Layout = schema::Layout<
+    VTG, types::Type::VTG,
+    schema::Field<&VTG::course_true, &tools::parse_course, 1>,
+    schema::Field<&VTG::course_magnetic, &tools::parse_course, 3>,
+    schema::Field<&VTG::speed_knots,
+                  schema::bind_back<&tools::parse_speed,
+                                    types::SpeedUnits::knots>,
+                  5>,
+    schema::Field<&VTG::speed_kmh,
+                  schema::bind_back<&tools::parse_speed,
+                                    types::SpeedUnits::kmh>,
+                  7>,
+    schema::Skip<8>,
+    schema::OptionalField<&VTG::mode, &tools::parse_mode, 9>>;
+
+/// @brief Minimum number of fields, header included.
+/// The mode indicator (NMEA 2.3+) is optional.
+constexpr std::size_t MIN_FIELDS{Layout::MIN_FIELDS};
+
+inline std::expected<VTG, types::ParseError>
+parse(const types::Header &header, const tools::Tokens &tokens) noexcept {
+  return Layout::parse(header, tokens);
+}
+
+inline std::expected<VTG, types::ParseError>
+parse(std::string_view sample) noexcept {
+  return Layout::parse(sample);
+}
+
+/// @brief Writes @p data into @p buffer as a complete sentence, checksum
+/// and CRLF included, without allocating.
+/// @return The sentence length, or BufferOverflow when @p buffer is too
+/// small.
+inline std::expected<std::size_t, types::ParseError>
+encode(const VTG &data, std::span<char> buffer) noexcept {
+  serialize::SentenceWriter out{buffer};
+  out.begin(data.talker, data.type);
+  out.number(data.course_true.transform(&types::Course::value_degrees));
+  out.field('T');
+  out.number(data.course_magnetic.transform(&types::Course::value_degrees));
+  out.field('M');
+  out.number(data.speed_knots.transform(&serialize::speed_token));
+  out.field('N');
+  out.number(data.speed_kmh.transform(&serialize::speed_token));
+  out.field('K');
+  if (data.mode) {
+    out.field(serialize::mode_code(data.mode.value()));
   }
+  return out.finish();
+}
 
-  auto tokens = tools::tokenize(sample);
+/// @brief VTG sentence decoded field by field on access; see SentenceView.
+class View : public SentenceView<Layout> {
+public:
+  using SentenceView::SentenceView;
 
-  if (tokens.empty()) {
-    return std::unexpected(types::ParseError::UnknownError);
+  decltype(auto) course_true() const noexcept {
+    return get<&VTG::course_true>();
+  }
+  decltype(auto) course_magnetic() const noexcept {
+    return get<&VTG::course_magnetic>();
   }
+  decltype(auto) speed_knots() const noexcept {
+    return get<&VTG::speed_knots>();
+  }
+  decltype(auto) speed_kmh() const noexcept { return get<&VTG::speed_kmh>(); }
+  decltype(auto) mode() const noexcept { return get<&VTG::mode>(); }
+};
 
-  return VTG{
-      tools::parse_type(tokens.at(0)),
-      tools::parse_course(tokens.at(1)),
-      tools::parse_course(tokens.at(3)),
-      tools::parse_speed(tokens.at(5), types::SpeedUnits::knots),
-      tools::parse_speed(tokens.at(7), types::SpeedUnits::kmh),
-      tools::parse_mode(tokens.at(9)),
-  };
+/// @brief Validates @p sample and returns a View over it without decoding
+/// any field.
+inline std::expected<View, types::ParseError>
+view(std::string_view sample) noexcept {
+  return make_view<View>(sample);
 }
 
 inline void print(const VTG &data) {
   std::println("Type: {}", p_tools::to_string(data.type));
+  std::println("Talker: {}", p_tools::to_string(data.talker));
   std::println("Course True: {}", p_tools::to_string(data.course_true));
   std::println("Course Magnetic: {}", p_tools::to_string(data.course_magnetic));
   std::println("Speed: {}", p_tools::to_string(data.speed_knots));
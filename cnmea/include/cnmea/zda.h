@@ -3,56 +3,109 @@
 #include <expected>
 #include <optional>
 
+#include "decode.h"
 #include "p_tools.h"
+#include "schema.h"
+#include "serialize.h"
 #include "tools.h"
 #include "types.h"
+#include "view.h"
 
 namespace cnmea::zda {
 
 struct ZDA {
   types::Type type;
-  types::UTCTime utc_time;
+  types::Talker talker;
+  std::optional<types::UTCTime> utc_time;
   int day;
   int month;
   int year;
   std::optional<int> local_zone_hours;
   std::optional<int> local_zone_minutes;
+
+  bool operator==(const ZDA &) const = default;
 };
 
-inline std::expected<ZDA, types::ParseError> parse(std::string_view sample) {
-  if (!tools::is_valid_sample(sample)) {
-    return std::unexpected(types::ParseError::InvalidFormat);
-  }
+/// @brief Field layout; MIN_FIELDS and the parsers are generated from it.
+using Layout = schema::Layout<
+    ZDA, types::Type::ZDA,
+    schema::Field<&ZDA::utc_time, &tools::parse_utc_time, 1>,
+    schema::OptionalField<&ZDA::day,
+                          schema::value_or<&decode::integer<int>, 0>, 2>,
+    schema::OptionalField<&ZDA::month,
+                          schema::value_or<&decode::integer<int>, 0>, 3>,
+    schema::OptionalField<&ZDA::year,
+                          schema::value_or<&decode::integer<int>, 0>, 4>,
+    schema::OptionalField<&ZDA::local_zone_hours,
+                          schema::value_or<&decode::integer<int>, 0>, 5>,
+    schema::OptionalField<&ZDA::local_zone_minutes,
+                          schema::value_or<&decode::integer<int>, 0>, 6>>;
 
-  auto tokens = tools::tokenize(sample);
+/// @brief Minimum number of fields, header included.
+/// Date and local zone fields default to 0 when absent.
+constexpr std::size_t MIN_FIELDS{Layout::MIN_FIELDS};
 
-  if (tokens.empty()) {
-    return std::unexpected(types::ParseError::UnknownError);
-  }
+inline std::expected<ZDA, types::ParseError>
+parse(const types::Header &header, const tools::Tokens &tokens) noexcept {
+  return Layout::parse(header, tokens);
+}
 
-  return ZDA{
-      tools::parse_type(tokens.at(0)),
-      tools::parse_utc_time(tokens.at(1)),
-      tokens.size() > 2 && !tokens.at(2).empty()
-          ? std::stoi(std::string{tokens.at(2)})
-          : 0,
-      tokens.size() > 3 && !tokens.at(3).empty()
-          ? std::stoi(std::string{tokens.at(3)})
-          : 0,
-      tokens.size() > 4 && !tokens.at(4).empty()
-          ? std::stoi(std::string{tokens.at(4)})
-          : 0,
-      tokens.size() > 5 && !tokens.at(5).empty()
-          ? std::stoi(std::string{tokens.at(5)})
-          : 0,
-      tokens.size() > 6 && !tokens.at(6).empty()
-          ? std::stoi(std::string{tokens.at(6)})
-          : 0,
+inline std::expected<ZDA, types::ParseError>
+parse(std::string_view sample) noexcept {
+  return Layout::parse(sample);
+}
+
+/// @brief Writes @p data into @p buffer as a complete sentence, checksum
+/// and CRLF included, without allocating.
+/// @return The sentence length, or BufferOverflow when @p buffer is too
+/// small.
+inline std::expected<std::size_t, types::ParseError>
+encode(const ZDA &data, std::span<char> buffer) noexcept {
+  serialize::SentenceWriter out{buffer};
+  out.begin(data.talker, data.type);
+  out.time(data.utc_time);
+  auto date_part = [&out](int value, int width) {
+    if (value > 0) {
+      out.integer(value, width);
+    } else {
+      out.empty();
+    }
   };
+  date_part(data.day, 2);
+  date_part(data.month, 2);
+  date_part(data.year, 4);
+  out.integer(data.local_zone_hours, 2);
+  out.integer(data.local_zone_minutes, 2);
+  return out.finish();
+}
+
+/// @brief ZDA sentence decoded field by field on access; see SentenceView.
+class View : public SentenceView<Layout> {
+public:
+  using SentenceView::SentenceView;
+
+  decltype(auto) utc_time() const noexcept { return get<&ZDA::utc_time>(); }
+  decltype(auto) day() const noexcept { return get<&ZDA::day>(); }
+  decltype(auto) month() const noexcept { return get<&ZDA::month>(); }
+  decltype(auto) year() const noexcept { return get<&ZDA::year>(); }
+  decltype(auto) local_zone_hours() const noexcept {
+    return get<&ZDA::local_zone_hours>();
+  }
+  decltype(auto) local_zone_minutes() const noexcept {
+    return get<&ZDA::local_zone_minutes>();
+  }
+};
+
+/// @brief Validates @p sample and returns a View over it without decoding
+/// any field.
+inline std::expected<View, types::ParseError>
+view(std::string_view sample) noexcept {
+  return make_view<View>(sample);
 }
 
 inline void print(const ZDA &data) {
   std::println("Type: {}", p_tools::to_string(data.type));
+  std::println("Talker: {}", p_tools::to_string(data.talker));
   std::println("UTC Time: {}", p_tools::to_string(data.utc_time));
   std::println("Day: {}", data.day);
   std::println("Month: {}", data.month);
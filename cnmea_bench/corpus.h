@@ -0,0 +1,254 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <format>
+#include <numbers>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @namespace corpus
+ * @brief Synthetic NMEA corpus generator used by cnmea_bench.
+ *
+ * Produces the sentence stream of a moving multi-constellation receiver:
+ * one epoch every 1/rate seconds, each carrying the enabled sentence types
+ * with valid checksums, optionally with a fraction of corrupted sentences.
+ */
+namespace corpus {
+
+/// @brief Sentence types that can be enabled in the mix.
+struct Mix {
+  bool gga{true};
+  bool gll{false};
+  bool rmc{true};
+  bool gsa{true};
+  bool gsv{true};
+  bool vtg{true};
+  bool zda{true};
+};
+
+/// @brief Generator configuration.
+struct Options {
+  std::size_t sentences{1'000'000};              ///< Lower bound on output
+  double rate_hz{10.0};                          ///< Epochs per second
+  std::vector<std::string> constellations{"GP"}; ///< GSV/GSA talkers
+  Mix mix{};                                     ///< Enabled sentence types
+  double corruption_rate{0.0};                   ///< Fraction corrupted
+  std::uint64_t seed{42};                        ///< PRNG seed
+
+  /// @brief Whether an epoch produces any sentence at all.
+  bool emits() const noexcept {
+    bool satellites = (mix.gsa || mix.gsv) && !constellations.empty();
+    return mix.gga || mix.gll || mix.rmc || mix.vtg || mix.zda || satellites;
+  }
+};
+
+/// @brief Generated corpus: concatenated CR/LF terminated sentences.
+struct Corpus {
+  std::string data;
+  std::size_t sentences{0};
+  std::size_t corrupted{0};
+};
+
+/// @brief Appends `*hh\r\n` to a sentence body starting with `$`.
+inline void finish_sentence(std::string &sentence) {
+  std::uint8_t check = 0;
+  for (char c : std::string_view{sentence}.substr(1)) {
+    check ^= static_cast<std::uint8_t>(c);
+  }
+  sentence += std::format("*{:02X}\r\n", check);
+}
+
+/// @brief Formats decimal degrees as an NMEA (D)DDMM.mmmmmm field pair.
+inline std::string coordinate(double degrees, int degree_digits,
+                              char positive, char negative) {
+  char hemisphere = degrees < 0 ? negative : positive;
+  auto micro_minutes = std::llround(std::fabs(degrees) * 60e6);
+  auto whole = micro_minutes / 60'000'000;
+  double minutes = static_cast<double>(micro_minutes % 60'000'000) / 1e6;
+  return std::format("{}{:09.6f},{}",
+                     degree_digits == 2 ? std::format("{:02}", whole)
+                                        : std::format("{:03}", whole),
+                     minutes, hemisphere);
+}
+
+class Generator {
+private:
+  struct Satellite {
+    int prn;
+    int elevation;
+    int azimuth;
+    int snr;
+  };
+
+  Options options;
+  std::mt19937_64 rng;
+  Corpus corpus;
+
+  // Receiver state
+  std::chrono::sys_time<std::chrono::milliseconds> time{
+      std::chrono::sys_days{std::chrono::year{2025} / 8 / 23} +
+      std::chrono::hours{23} + std::chrono::minutes{59}};
+  double latitude{40.416775};
+  double longitude{-3.703790};
+  double altitude{657.0};
+  double speed_knots{12.0};
+  double course{45.0};
+
+  double uniform(double low, double high) {
+    return std::uniform_real_distribution<double>{low, high}(rng);
+  }
+
+  int uniform(int low, int high) {
+    return std::uniform_int_distribution<int>{low, high}(rng);
+  }
+
+  std::string utc_time() const {
+    auto day = std::chrono::floor<std::chrono::days>(time);
+    std::chrono::hh_mm_ss clock{time - day};
+    return std::format("{:02}{:02}{:02}.{:02}", clock.hours().count(),
+                       clock.minutes().count(), clock.seconds().count(),
+                       clock.subseconds().count() / 10);
+  }
+
+  std::chrono::year_month_day date() const {
+    return std::chrono::year_month_day{
+        std::chrono::floor<std::chrono::days>(time)};
+  }
+
+  void emit(std::string sentence) {
+    finish_sentence(sentence);
+
+    if (options.corruption_rate > 0.0 &&
+        uniform(0.0, 1.0) < options.corruption_rate) {
+      corrupt(sentence);
+      corpus.corrupted++;
+    }
+
+    corpus.data += sentence;
+    corpus.sentences++;
+  }
+
+  /// Line noise: a flipped byte, a dropped tail or a lost checksum.
+  void corrupt(std::string &sentence) {
+    // Everything before the CR/LF terminator may be damaged.
+    int body = static_cast<int>(sentence.size()) - 2;
+    auto position = static_cast<std::size_t>(uniform(7, body - 1));
+    switch (uniform(0, 2)) {
+    case 0:
+      sentence[position] ^= 0x04;
+      break;
+    case 1:
+      sentence.erase(position, static_cast<std::size_t>(body) - position);
+      break;
+    default:
+      sentence.erase(static_cast<std::size_t>(body) - 3, 3);
+      break;
+    }
+  }
+
+  void step() {
+    double seconds = 1.0 / options.rate_hz;
+    double distance = speed_knots * 1852.0 * seconds;
+    double heading = course * std::numbers::pi / 180.0;
+    latitude += distance * std::cos(heading) / 111'320.0;
+    longitude += distance * std::sin(heading) /
+                 (111'320.0 * std::cos(latitude * std::numbers::pi / 180.0));
+    altitude += uniform(-0.2, 0.2);
+    speed_knots = std::max(0.0, speed_knots + uniform(-0.3, 0.3));
+    course = std::fmod(course + uniform(-2.0, 2.0) + 360.0, 360.0);
+    time += std::chrono::milliseconds{
+        static_cast<std::int64_t>(std::lround(seconds * 1000.0))};
+  }
+
+  void epoch() {
+    std::string now = utc_time();
+    std::string lat = coordinate(latitude, 2, 'N', 'S');
+    std::string lon = coordinate(longitude, 3, 'E', 'W');
+    auto ymd = date();
+    auto day = static_cast<unsigned>(ymd.day());
+    auto month = static_cast<unsigned>(ymd.month());
+    auto year = static_cast<int>(ymd.year());
+    double hdop = uniform(0.6, 1.6);
+
+    if (options.mix.gga) {
+      emit(std::format("$GNGGA,{},{},{},1,{:02},{:.1f},{:.1f},M,51.2,M,,",
+                       now, lat, lon, uniform(8, 24), hdop, altitude));
+    }
+    if (options.mix.gll) {
+      emit(std::format("$GNGLL,{},{},{},A,A", lat, lon, now));
+    }
+    if (options.mix.rmc) {
+      emit(std::format("$GNRMC,{},A,{},{},{:.3f},{:.2f},{:02}{:02}{:02},,,A",
+                       now, lat, lon, speed_knots, course, day, month,
+                       year % 100));
+    }
+    if (options.mix.vtg) {
+      emit(std::format("$GNVTG,{:.2f},T,,M,{:.3f},N,{:.3f},K,A", course,
+                       speed_knots, speed_knots * 1.852));
+    }
+    if (options.mix.zda) {
+      emit(std::format("$GNZDA,{},{:02},{:02},{},00,00", now, day, month,
+                       year));
+    }
+
+    for (const std::string &talker : options.constellations) {
+      std::vector<Satellite> satellites(static_cast<std::size_t>(
+          uniform(6, 14)));
+      int prn = talker == "GL" ? 65 : 1;
+      for (Satellite &satellite : satellites) {
+        satellite = {prn, uniform(5, 85), uniform(0, 359), uniform(15, 48)};
+        prn += uniform(1, 3);
+      }
+
+      if (options.mix.gsa) {
+        std::string gsa = "$GNGSA,A,3";
+        for (std::size_t i = 0; i < 12; i++) {
+          gsa += i < satellites.size()
+                     ? std::format(",{:02}", satellites[i].prn)
+                     : std::string{","};
+        }
+        gsa += std::format(",{:.2f},{:.2f},{:.2f}", hdop * 1.4, hdop,
+                           hdop * 0.9);
+        emit(std::move(gsa));
+      }
+
+      if (options.mix.gsv) {
+        std::size_t total = (satellites.size() + 3) / 4;
+        for (std::size_t part = 0; part < total; part++) {
+          std::string gsv = std::format("${}GSV,{},{},{:02}", talker, total,
+                                        part + 1, satellites.size());
+          for (std::size_t i = part * 4;
+               i < std::min(satellites.size(), part * 4 + 4); i++) {
+            gsv += std::format(",{:02},{:02},{:03},{:02}", satellites[i].prn,
+                               satellites[i].elevation, satellites[i].azimuth,
+                               satellites[i].snr);
+          }
+          emit(std::move(gsv));
+        }
+      }
+    }
+  }
+
+public:
+  explicit Generator(Options options)
+      : options(std::move(options)), rng(this->options.seed) {}
+
+  Corpus generate() {
+    corpus.data.reserve(options.sentences * 72);
+    // An empty mix would never reach the requested count.
+    while (options.emits() && corpus.sentences < options.sentences) {
+      epoch();
+      step();
+    }
+    return std::move(corpus);
+  }
+};
+
+} // namespace corpus
@@ -0,0 +1,286 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cnmea/bulk.h>
+#include <cnmea/cnmea.h>
+#include <cnmea/parallel.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <print>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "corpus.h"
+
+namespace {
+
+struct Settings {
+  corpus::Options corpus{};
+  std::size_t max_threads{std::max(1u, std::thread::hardware_concurrency())};
+  std::size_t chunk_size{std::size_t{1} << 20};
+  bool chunk_arenas{true};
+  int repeat{3};
+  std::string write_corpus;
+  std::string output;
+};
+
+struct Run {
+  std::size_t threads;
+  double seconds;
+  std::size_t sentences;
+  std::array<std::size_t, cnmea::types::PARSE_ERRORS> errors;
+  double p50_ns;
+  double p99_ns;
+  double p999_ns;
+};
+
+void usage() {
+  std::println(stderr, "Usage: cnmea_bench [options]\n"
+                       "  --sentences N         corpus size (1000000)\n"
+                       "  --rate HZ             epochs per second (10)\n"
+                       "  --constellations L    GSV talkers, e.g. GP,GL,GA\n"
+                       "  --mix L               gga,gll,rmc,gsa,gsv,vtg,zda\n"
+                       "  --corruption F        corrupted fraction, 0..1 (0)\n"
+                       "  --seed S              generator seed (42)\n"
+                       "  --threads N           run 1..N threads\n"
+                       "  --chunk-size B        parallel chunk bytes\n"
+                       "  --arenas 0|1          per-chunk pmr arenas (1)\n"
+                       "  --repeat R            best of R runs (3)\n"
+                       "  --write-corpus PATH   save the generated corpus\n"
+                       "  --output PATH         JSON report (stdout)");
+}
+
+std::vector<std::string> split_list(std::string_view list) {
+  std::vector<std::string> items;
+  auto tokens = cnmea::tools::split(list, ',');
+  if (!tokens) {
+    return items;
+  }
+  for (std::string_view token : tokens.value()) {
+    if (!token.empty()) {
+      items.emplace_back(token);
+    }
+  }
+  return items;
+}
+
+bool parse_arguments(int argc, char **argv, Settings &settings) {
+  for (int i = 1; i < argc; i++) {
+    std::string_view option{argv[i]};
+
+    if (option == "--help" || i + 1 >= argc) {
+      return false;
+    }
+
+    std::string_view value{argv[++i]};
+    auto number = cnmea::decode::fixed_decimal(value);
+    auto integer = cnmea::decode::integer<std::size_t>(value);
+
+    if (option == "--sentences" && integer) {
+      settings.corpus.sentences = integer.value();
+    } else if (option == "--rate" && number && number.value() > 0.0) {
+      settings.corpus.rate_hz = number.value();
+    } else if (option == "--constellations") {
+      settings.corpus.constellations = split_list(value);
+    } else if (option == "--mix") {
+      corpus::Mix mix{false, false, false, false, false, false, false};
+      for (const std::string &type : split_list(value)) {
+        mix.gga |= type == "gga";
+        mix.gll |= type == "gll";
+        mix.rmc |= type == "rmc";
+        mix.gsa |= type == "gsa";
+        mix.gsv |= type == "gsv";
+        mix.vtg |= type == "vtg";
+        mix.zda |= type == "zda";
+      }
+      settings.corpus.mix = mix;
+    } else if (option == "--corruption" && number &&
+               number.value() >= 0.0 && number.value() <= 1.0) {
+      settings.corpus.corruption_rate = number.value();
+    } else if (option == "--seed" && integer) {
+      settings.corpus.seed = integer.value();
+    } else if (option == "--threads" && integer && integer.value() > 0) {
+      settings.max_threads = integer.value();
+    } else if (option == "--chunk-size" && integer) {
+      settings.chunk_size = integer.value();
+    } else if (option == "--arenas" && integer && integer.value() <= 1) {
+      settings.chunk_arenas = integer.value() == 1;
+    } else if (option == "--repeat" && integer && integer.value() > 0) {
+      settings.repeat = static_cast<int>(integer.value());
+    } else if (option == "--write-corpus") {
+      settings.write_corpus = value;
+    } else if (option == "--output") {
+      settings.output = value;
+    } else {
+      return false;
+    }
+  }
+  return settings.corpus.emits();
+}
+
+double percentile(std::vector<std::uint32_t> &latencies, double fraction) {
+  if (latencies.empty()) {
+    return 0.0;
+  }
+  auto index = static_cast<std::size_t>(
+      fraction * static_cast<double>(latencies.size() - 1));
+  std::nth_element(latencies.begin(), latencies.begin() + index,
+                   latencies.end());
+  return latencies[index];
+}
+
+/// Parses the corpus through the full framing + parse pipeline.
+Run measure_throughput(std::string_view data, std::size_t threads,
+                       const Settings &settings) {
+  Run run{threads, 0.0, 0, {}, 0.0, 0.0, 0.0};
+
+  for (int r = 0; r < settings.repeat; r++) {
+    std::array<std::size_t, cnmea::types::PARSE_ERRORS> errors{};
+    auto start = std::chrono::steady_clock::now();
+
+    std::size_t sentences = cnmea::parallel::parse_buffer(
+        data, {threads, settings.chunk_size, false, settings.chunk_arenas},
+        [&](const cnmea::Result &result) {
+          if (!result) {
+            errors[static_cast<std::size_t>(result.error())]++;
+          }
+        });
+
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    if (r == 0 || elapsed.count() < run.seconds) {
+      run.seconds = elapsed.count();
+      run.sentences = sentences;
+      run.errors = errors;
+    }
+  }
+
+  return run;
+}
+
+/// Times every sentence individually, each thread on its own slice.
+void measure_latency(const std::vector<std::string_view> &sentences,
+                     Run &run) {
+  std::vector<std::uint32_t> latencies(sentences.size());
+  std::size_t slice = (sentences.size() + run.threads - 1) / run.threads;
+
+  {
+    std::vector<std::jthread> workers;
+    for (std::size_t t = 0; t < run.threads; t++) {
+      workers.emplace_back([&, t] {
+        std::size_t end = std::min(sentences.size(), (t + 1) * slice);
+        for (std::size_t i = t * slice; i < end; i++) {
+          auto start = std::chrono::steady_clock::now();
+          auto result = cnmea::parse(sentences[i]);
+          auto stop = std::chrono::steady_clock::now();
+          asm volatile("" : : "r,m"(result) : "memory");
+          latencies[i] = static_cast<std::uint32_t>(
+              std::chrono::duration_cast<std::chrono::nanoseconds>(stop -
+                                                                   start)
+                  .count());
+        }
+      });
+    }
+  }
+
+  run.p50_ns = percentile(latencies, 0.50);
+  run.p99_ns = percentile(latencies, 0.99);
+  run.p999_ns = percentile(latencies, 0.999);
+}
+
+std::string to_json(const Settings &settings, const corpus::Corpus &data,
+                    const std::vector<Run> &runs) {
+  std::string json = "{\n  \"corpus\": {\n";
+  json += std::format("    \"sentences\": {},\n", data.sentences);
+  json += std::format("    \"bytes\": {},\n", data.data.size());
+  json += std::format("    \"corrupted\": {},\n", data.corrupted);
+  json += std::format("    \"corruption_rate\": {},\n",
+                      settings.corpus.corruption_rate);
+  json += std::format("    \"rate_hz\": {},\n", settings.corpus.rate_hz);
+  json += std::format("    \"seed\": {},\n", settings.corpus.seed);
+  json += std::format("    \"chunk_arenas\": {},\n", settings.chunk_arenas);
+  json += "    \"constellations\": [";
+  for (std::size_t i = 0; i < settings.corpus.constellations.size(); i++) {
+    json += std::format("{}\"{}\"", i == 0 ? "" : ", ",
+                        settings.corpus.constellations[i]);
+  }
+  json += "]\n  },\n  \"runs\": [\n";
+
+  for (std::size_t r = 0; r < runs.size(); r++) {
+    const Run &run = runs[r];
+    double bytes = static_cast<double>(data.data.size());
+    json += "    {\n";
+    json += std::format("      \"threads\": {},\n", run.threads);
+    json += std::format("      \"seconds\": {:.6f},\n", run.seconds);
+    json += std::format("      \"sentences\": {},\n", run.sentences);
+    json += std::format("      \"sentences_per_second\": {:.1f},\n",
+                        static_cast<double>(run.sentences) / run.seconds);
+    json += std::format("      \"mb_per_second\": {:.2f},\n",
+                        bytes / run.seconds / 1e6);
+    json += std::format("      \"latency_ns\": {{\"p50\": {:.0f}, \"p99\": "
+                        "{:.0f}, \"p999\": {:.0f}}},\n",
+                        run.p50_ns, run.p99_ns, run.p999_ns);
+    json += "      \"errors\": {";
+    bool first = true;
+    for (std::size_t e = 0; e < run.errors.size(); e++) {
+      if (run.errors[e] != 0) {
+        json += std::format(
+            "{}\"{}\": {}", first ? "" : ", ",
+            cnmea::to_string(static_cast<cnmea::types::ParseError>(e)),
+            run.errors[e]);
+        first = false;
+      }
+    }
+    json += std::format("}}\n    }}{}\n", r + 1 == runs.size() ? "" : ",");
+  }
+
+  json += "  ]\n}\n";
+  return json;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Settings settings;
+
+  if (!parse_arguments(argc, argv, settings)) {
+    usage();
+    return EXIT_FAILURE;
+  }
+
+  corpus::Corpus data = corpus::Generator{settings.corpus}.generate();
+
+  if (!settings.write_corpus.empty()) {
+    std::ofstream{settings.write_corpus, std::ios::binary} << data.data;
+  }
+
+  std::vector<std::string_view> sentences;
+  sentences.reserve(data.sentences);
+  cnmea::bulk::for_each_sentence(data.data, [&](std::string_view sentence) {
+    sentences.push_back(sentence);
+  });
+
+  std::vector<Run> runs;
+  for (std::size_t threads = 1; threads <= settings.max_threads; threads++) {
+    Run run = measure_throughput(data.data, threads, settings);
+    measure_latency(sentences, run);
+    runs.push_back(run);
+  }
+
+  std::string json = to_json(settings, data, runs);
+
+  if (settings.output.empty()) {
+    std::print("{}", json);
+  } else {
+    std::ofstream{settings.output} << json;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,254 @@
+#include <atomic>
+#include <chrono>
+#include <cnmea/bulk.h>
+#include <cnmea/cnmea.h>
+#include <cnmea/fix.h>
+#include <cnmea/pipeline.h>
+#include <cnmea/record.h>
+#include <cnmea/simd.h>
+#include <cnmea/skyview.h>
+#include <cstdlib>
+#include <new>
+#include <print>
+#include <string>
+#include <string_view>
+
+// Every heap allocation made by the process is counted, so each benchmark
+// can report allocations per operation.
+namespace {
+std::atomic<std::size_t> allocations{0};
+std::atomic<std::size_t> allocated_bytes{0};
+} // namespace
+
+void *operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+#if defined(__cpp_exceptions)
+  throw std::bad_alloc{};
+#else
+  std::abort();
+#endif
+}
+
+void *operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+constexpr std::string_view GGA_SAMPLE{
+    "$GNGGA,062735.00,3150.788156,N,11711.922383,E,1,12,2.0,90.0,M,,M,,*55"};
+constexpr std::string_view GLL_SAMPLE{
+    "$GNGLL,3150.788156,N,11711.922383,E,062735.00,A,A*76"};
+constexpr std::string_view GSA_SAMPLE{
+    "$GNGSA,A,3,86,74,85,75,84,,,,,,,,1.96,1.36,1.42*1F"};
+constexpr std::string_view GSV_SAMPLE{
+    "$GPGSV,4,1,14,05,03,036,,16,36,309,29,18,11,139,,20,20,087,12*77"};
+constexpr std::string_view RMC_SAMPLE{
+    "$GNRMC,211041.00,A,4024.98796,N,00340.22512,W,0.027,,010218,,,D*7B"};
+constexpr std::string_view VTG_SAMPLE{
+    "$GNVTG,054.7,T,034.4,M,005.5,N,010.2,K,A*3B"};
+constexpr std::string_view ZDA_SAMPLE{"$GNZDA,201530.00,04,07,2002,00,00*7E"};
+
+/// Keeps the optimizer from discarding a benchmarked result.
+template <typename T> void do_not_optimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// Hides @p value from the optimizer so inputs are not constant-folded.
+std::string_view input(std::string_view value) {
+  asm volatile("" : "+m"(value));
+  return value;
+}
+
+/// Runs @p operation until at least 200 ms have elapsed and prints ns/op,
+/// allocations/op and throughput over @p bytes_per_op input bytes.
+template <typename Operation>
+void benchmark(std::string_view name, std::size_t bytes_per_op,
+               Operation &&operation) {
+  using clock = std::chrono::steady_clock;
+
+  for (int i = 0; i < 1000; i++) {
+    do_not_optimize(operation());
+  }
+
+  std::size_t iterations = 0;
+  std::size_t batch = 1000;
+  std::size_t start_allocations = allocations.load();
+  std::size_t start_bytes = allocated_bytes.load();
+  auto start = clock::now();
+  auto elapsed = clock::duration::zero();
+
+  while (elapsed < std::chrono::milliseconds(200)) {
+    for (std::size_t i = 0; i < batch; i++) {
+      do_not_optimize(operation());
+    }
+    iterations += batch;
+    elapsed = clock::now() - start;
+  }
+
+  double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+  double ns_per_op = ns / static_cast<double>(iterations);
+  double allocs_per_op =
+      static_cast<double>(allocations.load() - start_allocations) /
+      static_cast<double>(iterations);
+  double alloc_bytes_per_op =
+      static_cast<double>(allocated_bytes.load() - start_bytes) /
+      static_cast<double>(iterations);
+  double mb_per_s = static_cast<double>(bytes_per_op) / ns_per_op * 1e3;
+
+  std::println("{:<32} {:>10.1f} {:>10.2f} {:>12.1f} {:>10.1f}", name,
+               ns_per_op, allocs_per_op, alloc_bytes_per_op, mb_per_s);
+}
+
+} // namespace
+
+int main() {
+  using namespace cnmea;
+
+  std::println("{:<32} {:>10} {:>10} {:>12} {:>10}", "benchmark", "ns/op",
+               "allocs/op", "alloc B/op", "MB/s");
+
+  // Vector kernels and buffer framing
+  std::string log;
+  while (log.size() < 64 * 1024) {
+    for (std::string_view sample : {GGA_SAMPLE, GSA_SAMPLE, GSV_SAMPLE,
+                                    RMC_SAMPLE, VTG_SAMPLE, ZDA_SAMPLE}) {
+      log.append(sample).append("\r\n");
+    }
+  }
+  std::println("simd kernels: {}", simd::kernel_name());
+  benchmark("simd::classify (64 B)", simd::BLOCK,
+            [] { return simd::classify(input(GGA_SAMPLE).data()); });
+  benchmark("simd::xor_reduce", GGA_SAMPLE.size(),
+            [] { return simd::xor_reduce(input(GGA_SAMPLE)); });
+  benchmark("bulk::for_each_sentence (64 KiB)", log.size(), [&] {
+    std::size_t sentences = 0;
+    bulk::for_each_sentence(input(log),
+                            [&](std::string_view) { sentences++; });
+    return sentences;
+  });
+
+  Filter valid_rmc;
+  valid_rmc.only_types({types::Type::RMC}).match(types::Type::RMC, 2, "A");
+  benchmark("bulk::parse_buffer (64 KiB)", log.size(), [&] {
+    return bulk::parse_buffer(input(log), [](const Result &) {});
+  });
+  benchmark("bulk::parse_buffer (RMC, A)", log.size(), [&] {
+    return bulk::parse_buffer(input(log), valid_rmc, [](const Result &) {});
+  });
+
+  // Sentence-level primitives
+  benchmark("tools::parse_header", GGA_SAMPLE.size(),
+            [] { return tools::parse_header(input(GGA_SAMPLE)); });
+  benchmark("tools::split", GGA_SAMPLE.size(),
+            [] { return tools::split(input(GGA_SAMPLE), ','); });
+  benchmark("tools::tokenize", GGA_SAMPLE.size(),
+            [] { return tools::tokenize(input(GGA_SAMPLE)); });
+  benchmark("tools::scan", GGA_SAMPLE.size(),
+            [] { return tools::scan(input(GGA_SAMPLE)); });
+  benchmark("tools::is_valid_sample", GGA_SAMPLE.size(),
+            [] { return tools::is_valid_sample(input(GGA_SAMPLE)); });
+
+  benchmark("Filter::accepts (type)", GGA_SAMPLE.size(),
+            [&] { return valid_rmc.accepts(input(GGA_SAMPLE)); });
+  benchmark("Filter::accepts (field)", RMC_SAMPLE.size(),
+            [&] { return valid_rmc.accepts(input(RMC_SAMPLE)); });
+
+  // Field decoders
+  benchmark("tools::parse_numeric_value", 4,
+            [] { return tools::parse_numeric_value(input("90.0")); });
+  benchmark("tools::parse_coordinate", 11,
+            [] { return tools::parse_coordinate(input("3150.788156")); });
+  benchmark("decode::integer", 2,
+            [] { return decode::integer<int>(input("12")); });
+  benchmark("tools::parse_utc_time", 9,
+            [] { return tools::parse_utc_time(input("062735.00")); });
+  benchmark("tools::parse_satellite", 11, [] {
+    return tools::parse_satellite(input("16"), input("36"), input("309"),
+                                  input("29"));
+  });
+
+  // Enum decoders
+  benchmark("tools::parse_fix_quality", 1,
+            [] { return tools::parse_fix_quality(input("4")); });
+  benchmark("tools::parse_status", 1,
+            [] { return tools::parse_status(input("A")); });
+  benchmark("tools::parse_mode", 1,
+            [] { return tools::parse_mode(input("D")); });
+  benchmark("tools::parse_selection_mode", 1,
+            [] { return tools::parse_selection_mode(input("A")); });
+  benchmark("tools::parse_fix_type", 1,
+            [] { return tools::parse_fix_type(input("3")); });
+
+  // Per-sentence parsers
+  benchmark("gga::parse", GGA_SAMPLE.size(),
+            [] { return gga::parse(input(GGA_SAMPLE)); });
+  benchmark("gll::parse", GLL_SAMPLE.size(),
+            [] { return gll::parse(input(GLL_SAMPLE)); });
+  benchmark("gsa::parse", GSA_SAMPLE.size(),
+            [] { return gsa::parse(input(GSA_SAMPLE)); });
+  benchmark("gsv::parse", GSV_SAMPLE.size(),
+            [] { return gsv::parse(input(GSV_SAMPLE)); });
+  benchmark("rmc::parse", RMC_SAMPLE.size(),
+            [] { return rmc::parse(input(RMC_SAMPLE)); });
+  benchmark("vtg::parse", VTG_SAMPLE.size(),
+            [] { return vtg::parse(input(VTG_SAMPLE)); });
+  benchmark("zda::parse", ZDA_SAMPLE.size(),
+            [] { return zda::parse(input(ZDA_SAMPLE)); });
+  benchmark("cnmea::parse (GGA)", GGA_SAMPLE.size(),
+            [] { return cnmea::parse(input(GGA_SAMPLE)); });
+
+  // Lazy views reading position and fix quality only
+  benchmark("gga::view (3 fields)", GGA_SAMPLE.size(), [] {
+    auto view = gga::view(input(GGA_SAMPLE));
+    return view && view->latitude() && view->longitude() &&
+           view->fix_quality();
+  });
+  benchmark("gga::parse (3 fields)", GGA_SAMPLE.size(), [] {
+    auto gga = gga::parse(input(GGA_SAMPLE));
+    return gga && gga->latitude && gga->longitude &&
+           gga->fix_quality != types::FixQuality::Invalid;
+  });
+
+  // Stateful consumers
+  SkyViewAssembler assembler;
+  benchmark("SkyViewAssembler::push (GSV)", GSV_SAMPLE.size(),
+            [&] { return assembler.push(input(GSV_SAMPLE)); });
+  FixAggregator aggregator;
+  const Sample rmc = rmc::parse(RMC_SAMPLE).value();
+  benchmark("FixAggregator::push (RMC)", RMC_SAMPLE.size(),
+            [&] { return aggregator.push(rmc); });
+
+  // Binary records
+  benchmark("record::encode (RMC)", sizeof(record::Record),
+            [&] { return record::encode(rmc).presence; });
+  const record::Record encoded = record::encode(rmc);
+  benchmark("record::decode (RMC)", sizeof(record::Record),
+            [&] { return record::decode(encoded); });
+
+  // Pipeline rings, both ends on this thread
+  pipeline::SpscRing<Sample> ring{1024};
+  benchmark("SpscRing push+pop (RMC)", RMC_SAMPLE.size(), [&] {
+    ring.push(rmc);
+    return ring.pop();
+  });
+
+  // Sentence encoders
+  char sentence[serialize::MAX_LENGTH];
+  const gga::GGA gga_data = gga::parse(GGA_SAMPLE).value();
+  benchmark("gga::encode", GGA_SAMPLE.size(),
+            [&] { return gga::encode(gga_data, sentence); });
+  const gsv::GSV gsv_data = gsv::parse(GSV_SAMPLE).value();
+  benchmark("gsv::encode", GSV_SAMPLE.size(),
+            [&] { return gsv::encode(gsv_data, sentence); });
+  benchmark("cnmea::encode (RMC)", RMC_SAMPLE.size(),
+            [&] { return cnmea::encode(rmc, sentence); });
+
+  return EXIT_SUCCESS;
+}
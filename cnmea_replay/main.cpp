@@ -0,0 +1,193 @@
+#include <atomic>
+#include <cnmea/decode.h>
+#include <cnmea/replay.h>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <print>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct Settings {
+  cnmea::replay::Options replay{};
+  std::size_t receivers{1};
+  bool to_stdout{false};
+  std::string link;
+  std::string log;
+};
+
+void usage() {
+  std::println(stderr,
+               "Usage: cnmea_replay [options] LOG\n"
+               "  --speed X|max       times real time (1)\n"
+               "  --receivers N       virtual receivers, one pty each (1)\n"
+               "  --loops N           passes over the log, 0 = forever (1)\n"
+               "  --link PREFIX       symlink PREFIX0, PREFIX1, ... to ptys\n"
+               "  --stdout            write to stdout instead of a pty");
+}
+
+bool parse_arguments(int argc, char **argv, Settings &settings) {
+  for (int i = 1; i < argc; i++) {
+    std::string_view option{argv[i]};
+
+    if (!option.starts_with("--")) {
+      settings.log = option;
+      continue;
+    }
+    if (option == "--stdout") {
+      settings.to_stdout = true;
+      continue;
+    }
+    if (option == "--help" || i + 1 >= argc) {
+      return false;
+    }
+
+    std::string_view value{argv[++i]};
+    auto number = cnmea::decode::fixed_decimal(value);
+    auto integer = cnmea::decode::integer<std::size_t>(value);
+
+    if (option == "--speed" && value == "max") {
+      settings.replay.speed = 0.0;
+    } else if (option == "--speed" && number && number.value() > 0.0) {
+      settings.replay.speed = number.value();
+    } else if (option == "--receivers" && integer && integer.value() > 0) {
+      settings.receivers = integer.value();
+    } else if (option == "--loops" && integer) {
+      settings.replay.loops = integer.value();
+    } else if (option == "--link") {
+      settings.link = value;
+    } else {
+      return false;
+    }
+  }
+  return !settings.log.empty() &&
+         !(settings.to_stdout && settings.receivers != 1);
+}
+
+void print_report(const cnmea::replay::Report &report) {
+  const cnmea::replay::Stats &total = report.total;
+  std::println(stderr, "epochs:     {}", total.epochs);
+  std::println(stderr, "sentences:  {} ({:.1f}/s)", total.sentences,
+               report.sentences_per_second());
+  std::println(stderr, "bytes:      {} ({} dropped)", total.bytes,
+               total.dropped_bytes);
+  std::println(stderr, "log time:   {:.3f} s in {:.3f} s",
+               static_cast<double>(total.log_ns) / 1e9, report.wall_seconds);
+  if (report.requested_speed > 0.0) {
+    std::println(stderr, "speed:      {:.3f}x requested, {:.3f}x achieved",
+                 report.requested_speed, report.achieved_speed);
+    std::println(stderr, "max lag:    {:.3f} ms",
+                 static_cast<double>(report.max_lag_ns) / 1e6);
+  } else {
+    std::println(stderr, "speed:      max requested, {:.1f}x achieved",
+                 report.achieved_speed);
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Settings settings;
+
+  if (!parse_arguments(argc, argv, settings)) {
+    usage();
+    return EXIT_FAILURE;
+  }
+
+  auto schedule = cnmea::replay::Schedule::load(settings.log);
+
+  if (!schedule) {
+    std::println(stderr, "cannot read {}: {}", settings.log,
+                 cnmea::to_string(schedule.error()));
+    return EXIT_FAILURE;
+  }
+
+  std::println(stderr, "{}: {} sentences in {} epochs over {:.3f} s",
+               settings.log, schedule->sentences(), schedule->epochs().size(),
+               static_cast<double>(schedule->duration_ns()) / 1e9);
+
+  cnmea::replay::Replayer replayer;
+  std::vector<cnmea::replay::PseudoTerminal> terminals;
+  std::vector<std::filesystem::path> links;
+  auto remove_links = [&links] {
+    for (const std::filesystem::path &link : links) {
+      std::error_code error;
+      std::filesystem::remove(link, error);
+    }
+  };
+
+  if (settings.to_stdout) {
+    replayer.add(schedule.value(), STDOUT_FILENO);
+  }
+
+  for (std::size_t i = 0; !settings.to_stdout && i < settings.receivers;
+       i++) {
+    auto terminal = cnmea::replay::PseudoTerminal::open();
+
+    if (!terminal) {
+      std::println(stderr, "cannot open a pseudo-terminal");
+      remove_links();
+      return EXIT_FAILURE;
+    }
+
+    std::string name = terminal->name();
+    if (!settings.link.empty()) {
+      std::filesystem::path link{settings.link + std::to_string(i)};
+      std::error_code error;
+      // Replace a link left by an earlier run, but nothing else.
+      if (std::filesystem::is_symlink(link, error)) {
+        std::filesystem::remove(link, error);
+      }
+      std::filesystem::create_symlink(name, link, error);
+      if (error) {
+        std::println(stderr, "cannot link {}: {}", link.string(),
+                     error.message());
+        remove_links();
+        return EXIT_FAILURE;
+      }
+      links.push_back(link);
+      name = link.string();
+    }
+
+    std::println(stderr, "receiver {}: {}", i, name);
+    replayer.add(schedule.value(), terminal->fd());
+    terminals.push_back(std::move(terminal.value()));
+  }
+
+  // SIGINT and SIGTERM are taken synchronously below and stop the replay.
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  cnmea::replay::Report report;
+  std::atomic<bool> done{false};
+
+  {
+    std::jthread worker{[&](std::stop_token stop) {
+      report = replayer.run(settings.replay, stop);
+      done = true;
+    }};
+
+    const timespec poll{0, 100'000'000};
+    while (!done) {
+      if (sigtimedwait(&signals, nullptr, &poll) > 0) {
+        worker.request_stop();
+        break;
+      }
+    }
+  }
+
+  remove_links();
+  print_report(report);
+  return EXIT_SUCCESS;
+}
@@ -1,5 +1,6 @@
 #include <__ostream/print.h>
 #include <cnmea/cnmea.h>
+#include <cnmea/stream.h>
 #include <cstdlib>
 #include <print>
 
@@ -76,5 +77,22 @@ int main() {
     std::println("Error: {}", cnmea::to_string(zda_result.error()));
   }
 
+  std::println("--------------------------------------------------");
+
+  // Sentences arriving in arbitrary chunks, as read() returns them.
+  cnmea::StreamParser stream_parser;
+
+  for (std::string_view chunk : {"$GNGLL,3150.788156,N,117", "11.922383,E,06",
+                                 "2735.00,A,A*76\r\n$GNVTG,054.7,T,034.4,M,",
+                                 "005.5,N,010.2,K,A*3B\r\n"}) {
+    stream_parser.feed(chunk, [](const auto &result) {
+      if (result) {
+        cnmea::print(result.value());
+      } else {
+        std::println("Error: {}", cnmea::to_string(result.error()));
+      }
+    });
+  }
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdlib>
+#include <print>
+#include <source_location>
+#include <string_view>
+
+/**
+ * @namespace cnmea::test
+ * @brief Minimal assertions for the CTest executables.
+ */
+namespace cnmea::test {
+
+inline int failures{0};
+
+/// @brief Reports @p expression when @p condition is false and counts it.
+inline void check(bool condition, std::string_view expression,
+                  std::source_location where = std::source_location::current()) {
+  if (!condition) {
+    std::println(stderr, "{}:{}: check failed: {}", where.file_name(),
+                 where.line(), expression);
+    failures++;
+  }
+}
+
+/// @brief Exit status of a test executable.
+inline int result() { return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE; }
+
+} // namespace cnmea::test
+
+#define CHECK(...)                                                             \
+  ::cnmea::test::check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__)
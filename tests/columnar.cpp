@@ -0,0 +1,131 @@
+#include "check.h"
+
+#include <cmath>
+#include <cnmea/columnar.h>
+#include <cstddef>
+#include <string_view>
+
+namespace {
+
+using cnmea::types::ParseError;
+
+constexpr std::string_view GGA_FEET{
+    "$GPGGA,123519.00,4807.038000,N,01131.000000,E,1,08,0.9,1000,FT,46.9,M,,"
+    "*19"};
+constexpr std::string_view GGA_KILOMETERS{
+    "$GPGGA,123520.00,4807.038000,N,01131.000000,E,1,08,0.9,1.5,KM,46.9,M,,"
+    "*2C"};
+constexpr std::string_view GGA_METERS{
+    "$GPGGA,123519.00,4807.038000,N,01131.000000,E,1,08,0.9,545.4,M,46.9,M,,"
+    "*69"};
+/// No position or altitude, and an empty HDOP.
+constexpr std::string_view GGA_EMPTY{"$GPGGA,123521.00,,,,,0,00,,,,,,,*4E"};
+/// No speed.
+constexpr std::string_view RMC_NO_SPEED{
+    "$GPRMC,123519.00,A,4807.038000,N,01131.000000,E,,84.4,230394,3.1,W,A*33"};
+constexpr std::string_view VTG{"$GPVTG,54.7,T,34.4,M,5.5,N,10.2,K,A*15"};
+constexpr std::string_view GSA{
+    "$GNGSA,A,3,86,74,85,75,84,,,,,,,,1.96,1.36,1.42*1F"};
+constexpr std::string_view ZDA{"$GPZDA,201530.00,04,07,2002,-05,00*48"};
+
+std::size_t errors(const cnmea::columnar::Batch &batch, ParseError error) {
+  return batch.errors[static_cast<std::size_t>(error)];
+}
+
+/// Missing optional fields clear their validity bit and hold NaN.
+void missing_fields() {
+  cnmea::columnar::Builder builder;
+  builder.push(GGA_METERS);
+  builder.push(GGA_EMPTY);
+  builder.push(RMC_NO_SPEED);
+
+  const auto &gga = builder.batch().gga;
+  CHECK(gga.size() == 2);
+  CHECK(gga.latitude.valid(0) && !gga.latitude.valid(1));
+  CHECK(gga.altitude.valid(0) && !gga.altitude.valid(1));
+  CHECK(std::isnan(gga.latitude.values()[1]));
+  CHECK(gga.latitude.bitmap().size() == 1 && gga.latitude.bitmap()[0] == 1);
+  // Mandatory in GGA, so always present.
+  CHECK(gga.fix_quality.valid(1) && gga.fix_quality.values()[1] == 0);
+  CHECK(gga.hdop.valid(1) && gga.hdop.values()[1] == 0.0);
+
+  const auto &rmc = builder.batch().rmc;
+  CHECK(rmc.size() == 1);
+  CHECK(!rmc.speed.valid(0) && std::isnan(rmc.speed.values()[0]));
+  CHECK(rmc.course.valid(0) && rmc.course.values()[0] == 84.4);
+}
+
+/// Altitudes are stored in meters whatever units they were sent in.
+void altitude_in_meters() {
+  cnmea::columnar::Builder builder;
+  builder.push(GGA_METERS);
+  builder.push(GGA_FEET);
+  builder.push(GGA_KILOMETERS);
+
+  auto altitude = builder.batch().gga.altitude.values();
+  CHECK(altitude.size() == 3);
+  CHECK(altitude[0] == 545.4);
+  CHECK(std::fabs(altitude[1] - 304.8) < 1e-9);
+  CHECK(altitude[2] == 1500.0);
+}
+
+/// Each parse error has its own counter; parsed sentences without a table
+/// are counted as skipped.
+void errors_and_skipped() {
+  cnmea::columnar::Builder builder;
+  builder.push("$GPGGA,123519.00,4807.038000,N,01131.000000,E,1,08,0.9,"
+               "545.4,M,46.9,M,,*00");
+  builder.push("$GPTXT,01,01,02,hello*2F");
+  builder.push("$GPTXT,01,01,02,hello*2F");
+  builder.push(GSA);
+  builder.push(ZDA);
+  builder.push(VTG);
+
+  const cnmea::columnar::Batch &batch = builder.batch();
+  CHECK(errors(batch, ParseError::InvalidChecksum) == 1);
+  CHECK(errors(batch, ParseError::UnsupportedType) == 2);
+  CHECK(errors(batch, ParseError::IOError) == 0);
+  CHECK(batch.skipped == 2);
+  CHECK(batch.gga.size() == 0 && batch.vtg.size() == 1);
+
+  std::size_t total = 0;
+  for (std::size_t count : batch.errors) {
+    total += count;
+  }
+  CHECK(total == 3);
+}
+
+/// take() hands over the batch and leaves an empty, reusable builder.
+void reserve_and_take() {
+  cnmea::columnar::Builder builder;
+  builder.reserve(1000);
+  for (int i = 0; i < 100; i++) {
+    builder.push(GGA_METERS);
+  }
+  builder.push("$GPTXT,01,01,02,hello*2F");
+
+  cnmea::columnar::Batch first = builder.take();
+  CHECK(first.gga.size() == 100 && first.gga.altitude.bitmap().size() == 2);
+  CHECK(errors(first, ParseError::UnsupportedType) == 1);
+
+  const cnmea::columnar::Batch &empty = builder.batch();
+  CHECK(empty.gga.size() == 0 && empty.gga.altitude.bitmap().empty());
+  CHECK(errors(empty, ParseError::UnsupportedType) == 0);
+
+  builder.push(VTG);
+  builder.push(GGA_FEET);
+  cnmea::columnar::Batch second = builder.take();
+  CHECK(second.vtg.size() == 1 && second.gga.size() == 1);
+  CHECK(second.gga.altitude.valid(0));
+  CHECK(first.gga.size() == 100);
+}
+
+} // namespace
+
+int main() {
+  missing_fields();
+  altitude_in_meters();
+  errors_and_skipped();
+  reserve_and_take();
+  return cnmea::test::result();
+}
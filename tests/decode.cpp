@@ -0,0 +1,36 @@
+#include "check.h"
+
+#include <cnmea/decode.h>
+#include <cstdint>
+
+namespace {
+
+using cnmea::types::ParseError;
+
+void signs() {
+  using cnmea::decode::fixed_decimal;
+  using cnmea::decode::integer;
+
+  CHECK(integer<int>("08") == 8);
+  CHECK(integer<int>("-05") == -5);
+  CHECK(integer<int>("+5") == 5);
+  CHECK(integer<int>("").error() == ParseError::MissingFields);
+  CHECK(integer<int>("+").error() == ParseError::InvalidFormat);
+  CHECK(integer<int>("+-5").error() == ParseError::InvalidFormat);
+  CHECK(integer<int>("--5").error() == ParseError::InvalidFormat);
+  CHECK(integer<std::uint8_t>("256").error() == ParseError::InvalidFormat);
+
+  // Integers and decimals accept the same signs.
+  CHECK(fixed_decimal("+5") == 5.0);
+  CHECK(fixed_decimal("+").error() == ParseError::InvalidFormat);
+  CHECK(fixed_decimal("+-5").error() == ParseError::InvalidFormat);
+  CHECK(fixed_decimal("+-12345678901234567890").error() ==
+        ParseError::InvalidFormat);
+}
+
+} // namespace
+
+int main() {
+  signs();
+  return cnmea::test::result();
+}
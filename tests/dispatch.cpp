@@ -0,0 +1,47 @@
+#include "check.h"
+
+#include <cnmea/cnmea.h>
+#include <cnmea/tools.h>
+#include <string_view>
+#include <variant>
+
+namespace {
+
+using cnmea::types::ParseError;
+using cnmea::types::Talker;
+using cnmea::types::Type;
+
+/// A GLL whose extra last field reads "GGA".
+constexpr std::string_view GLL_SAYING_GGA{"$GPGLL,,,,,225444.00,A,A,GGA*3E"};
+/// An unknown type whose payload reads "GGA".
+constexpr std::string_view TXT_SAYING_GGA{"$GPTXT,01,01,02,GGA*0C"};
+
+/// Only the fixed-position header picks the parser, never the payload.
+void payload_does_not_dispatch() {
+  auto gll = cnmea::parse(GLL_SAYING_GGA);
+  CHECK(gll.has_value() && std::holds_alternative<cnmea::GLL>(gll.value()));
+
+  auto txt = cnmea::parse(TXT_SAYING_GGA);
+  CHECK(!txt && txt.error() == ParseError::UnsupportedType);
+}
+
+void header_fields() {
+  auto header = cnmea::tools::parse_header(GLL_SAYING_GGA);
+  CHECK(header && header->talker == Talker::GP && header->type == Type::GLL);
+
+  header = cnmea::tools::parse_header("$GNGGA*00");
+  CHECK(header && header->talker == Talker::GN && header->type == Type::GGA);
+
+  // The formatter is exactly three characters.
+  CHECK(!cnmea::tools::parse_header("$GPGGAX,123519.00"));
+  CHECK(!cnmea::tools::parse_header("$GPGG,GGA"));
+  CHECK(!cnmea::tools::parse_header("$GPTXT,GGA"));
+}
+
+} // namespace
+
+int main() {
+  payload_does_not_dispatch();
+  header_fields();
+  return cnmea::test::result();
+}
@@ -0,0 +1,96 @@
+#include "check.h"
+
+#include <cnmea/epoch.h>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace {
+
+constexpr std::int64_t NS_PER_SECOND{1'000'000'000};
+/// 2025-01-01T00:00:00Z
+constexpr std::int64_t NEW_YEAR_NS{1'735'689'600 * NS_PER_SECOND};
+
+std::optional<std::int64_t> stamp(cnmea::EpochResolver &resolver,
+                                  std::string_view sentence) {
+  auto stamped = resolver.parse(sentence);
+  CHECK(stamped.has_value());
+  return stamped ? stamped->epoch_ns : std::nullopt;
+}
+
+// A dated sentence right after midnight moves the day once, not twice.
+void midnight_with_dated_sentence() {
+  cnmea::EpochResolver resolver;
+
+  CHECK(stamp(resolver, "$GPRMC,235959.00,A,4916.45,N,12311.12,W,000.5,054.7,"
+                        "311224,020.3,E*46") == NEW_YEAR_NS - NS_PER_SECOND);
+  CHECK(stamp(resolver, "$GPGGA,235959.00,4916.45,N,12311.12,W,1,08,0.9,545.4,"
+                        "M,46.9,M,,*7D") == NEW_YEAR_NS - NS_PER_SECOND);
+  CHECK(stamp(resolver, "$GPRMC,000000.00,A,4916.45,N,12311.12,W,000.5,054.7,"
+                        "010125,020.3,E*47") == NEW_YEAR_NS);
+  CHECK(stamp(resolver, "$GPGGA,000001.00,4916.45,N,12311.12,W,1,08,0.9,545.4,"
+                        "M,46.9,M,,*7D") == NEW_YEAR_NS + NS_PER_SECOND);
+}
+
+// Without a dated sentence the time of day going back moves the day.
+void midnight_without_dated_sentence() {
+  cnmea::EpochResolver resolver;
+
+  CHECK(stamp(resolver, "$GPRMC,235959.00,A,4916.45,N,12311.12,W,000.5,054.7,"
+                        "311224,020.3,E*46") == NEW_YEAR_NS - NS_PER_SECOND);
+  CHECK(stamp(resolver, "$GPGGA,000001.00,4916.45,N,12311.12,W,1,08,0.9,545.4,"
+                        "M,46.9,M,,*7D") == NEW_YEAR_NS + NS_PER_SECOND);
+  CHECK(stamp(resolver, "$GPRMC,000000.00,A,4916.45,N,12311.12,W,000.5,054.7,"
+                        "010125,020.3,E*47") == NEW_YEAR_NS);
+  CHECK(stamp(resolver, "$GPGGA,000002.00,4916.45,N,12311.12,W,1,08,0.9,545.4,"
+                        "M,46.9,M,,*7E") == NEW_YEAR_NS + 2 * NS_PER_SECOND);
+}
+
+// A dated sentence from before midnight, sent after the time of day has
+// already rolled the day over, is stamped on its own date.
+void late_sentence_after_midnight() {
+  cnmea::EpochResolver resolver;
+
+  CHECK(stamp(resolver, "$GPRMC,235959.00,A,4916.45,N,12311.12,W,000.5,054.7,"
+                        "311224,020.3,E*46") == NEW_YEAR_NS - NS_PER_SECOND);
+  CHECK(stamp(resolver, "$GPGGA,000001.00,4916.45,N,12311.12,W,1,08,0.9,545.4,"
+                        "M,46.9,M,,*7D") == NEW_YEAR_NS + NS_PER_SECOND);
+  CHECK(stamp(resolver, "$GPRMC,235959.50,A,4916.45,N,12311.12,W,000.5,054.7,"
+                        "311224,020.3,E*43") ==
+        NEW_YEAR_NS - NS_PER_SECOND / 2);
+  CHECK(stamp(resolver, "$GPGGA,000002.00,4916.45,N,12311.12,W,1,08,0.9,545.4,"
+                        "M,46.9,M,,*7E") == NEW_YEAR_NS + 2 * NS_PER_SECOND);
+  CHECK(stamp(resolver, "$GPRMC,000003.00,A,4916.45,N,12311.12,W,000.5,054.7,"
+                        "010125,020.3,E*44") == NEW_YEAR_NS + 3 * NS_PER_SECOND);
+}
+
+void midnight_with_zda() {
+  cnmea::EpochResolver resolver;
+
+  CHECK(stamp(resolver, "$GPZDA,235959.50,31,12,2024,00,00*67") ==
+        NEW_YEAR_NS - NS_PER_SECOND / 2);
+  CHECK(stamp(resolver, "$GPZDA,000000.50,01,01,2025,00,00*66") ==
+        NEW_YEAR_NS + NS_PER_SECOND / 2);
+  CHECK(stamp(resolver, "$GPGGA,000001.00,4916.45,N,12311.12,W,1,08,0.9,545.4,"
+                        "M,46.9,M,,*7D") == NEW_YEAR_NS + NS_PER_SECOND);
+}
+
+void undated_until_first_date() {
+  cnmea::EpochResolver resolver;
+
+  CHECK(stamp(resolver, "$GPGGA,235959.00,4916.45,N,12311.12,W,1,08,0.9,545.4,"
+                        "M,46.9,M,,*7D") == std::nullopt);
+  CHECK(stamp(resolver, "$GPRMC,000000.00,A,4916.45,N,12311.12,W,000.5,054.7,"
+                        "010125,020.3,E*47") == NEW_YEAR_NS);
+}
+
+} // namespace
+
+int main() {
+  midnight_with_dated_sentence();
+  midnight_without_dated_sentence();
+  late_sentence_after_midnight();
+  midnight_with_zda();
+  undated_until_first_date();
+  return cnmea::test::result();
+}
@@ -0,0 +1,152 @@
+#include "check.h"
+
+#include <cnmea/bulk.h>
+#include <cnmea/filter.h>
+#include <cnmea/stream.h>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace {
+
+using cnmea::Filter;
+using cnmea::types::Talker;
+using cnmea::types::Type;
+
+constexpr std::string_view RMC_VALID{
+    "$GPRMC,123519.00,A,4807.038000,N,01131.000000,E,22.4,84.4,230394,3.1,W,"
+    "A*29"};
+constexpr std::string_view RMC_VOID{
+    "$GPRMC,123519.00,V,4807.038000,N,01131.000000,E,22.4,84.4,230394,3.1,W,"
+    "N*31"};
+constexpr std::string_view GGA_GPS{
+    "$GPGGA,123519.00,4807.038000,N,01131.000000,E,1,08,0.9,545.4,M,46.9,M,,"
+    "*69"};
+constexpr std::string_view GGA_RTK{
+    "$GPGGA,123519.00,4807.038000,N,01131.000000,E,4,08,0.9,545.4,M,46.9,M,,"
+    "*6C"};
+constexpr std::string_view GLL_GLONASS{
+    "$GLGLL,4916.450000,S,12311.120000,W,225444.00,A,A*73"};
+/// A sentence type the parsers do not know.
+constexpr std::string_view TXT{"$GPTXT,01,01,02,hello*2F"};
+
+void default_accepts_everything() {
+  Filter filter;
+  CHECK(filter.empty());
+  for (std::string_view sentence :
+       {RMC_VALID, RMC_VOID, GGA_GPS, GLL_GLONASS, TXT}) {
+    CHECK(filter.accepts(sentence));
+  }
+}
+
+void types_and_talkers() {
+  Filter types;
+  types.only_types({Type::GGA, Type::GLL});
+  CHECK(!types.empty());
+  CHECK(types.accepts(GGA_GPS) && types.accepts(GLL_GLONASS));
+  CHECK(!types.accepts(RMC_VALID));
+
+  Filter talkers;
+  talkers.only_talkers({Talker::GL});
+  CHECK(talkers.accepts(GLL_GLONASS));
+  CHECK(!talkers.accepts(GGA_GPS) && !talkers.accepts(RMC_VALID));
+}
+
+/// The example of the class documentation: indices count the header as
+/// field 0, so RMC 2 is the status and GGA 6 the fix quality.
+void conditions_on_fields() {
+  Filter filter;
+  filter.only_types({Type::GGA, Type::RMC})
+      .match(Type::RMC, 2, "A")
+      .match(Type::GGA, 6, "45");
+
+  CHECK(filter.accepts(RMC_VALID));
+  CHECK(!filter.accepts(RMC_VOID));
+  CHECK(filter.accepts(GGA_RTK));
+  CHECK(!filter.accepts(GGA_GPS));
+  CHECK(!filter.accepts(GLL_GLONASS));
+
+  // Conditions only apply to their own type.
+  Filter status;
+  status.require(Type::RMC, 2);
+  CHECK(status.accepts(GGA_GPS) && status.accepts(RMC_VOID));
+  CHECK(!status.accepts("$GPRMC,123519.00,,4807.038000,N*00"));
+}
+
+/// A sentence that ends before the field fails the condition.
+void fewer_fields_than_index() {
+  Filter filter;
+  filter.require(Type::RMC, 2);
+  CHECK(!filter.accepts("$GPRMC,123519.00"));
+  CHECK(!filter.accepts("$GPRMC,123519.00*00"));
+  CHECK(!filter.accepts("$GPRMC"));
+
+  Filter last;
+  last.match(Type::GLL, 7, "A");
+  CHECK(last.accepts(GLL_GLONASS));
+  last.match(Type::GLL, 8, "A");
+  CHECK(!last.accepts(GLL_GLONASS));
+}
+
+/// Undecodable headers reach the parser, to be reported, only when nothing
+/// is filtered.
+void undecodable_header() {
+  CHECK(Filter{}.accepts(TXT));
+  CHECK(Filter{}.accepts("garbage"));
+
+  Filter talkers;
+  talkers.only_talkers({Talker::GP});
+  CHECK(!talkers.accepts(TXT));
+  CHECK(!talkers.accepts("garbage"));
+}
+
+/// The bulk and stream entry points drop what the filter rejects and
+/// count only the rest.
+void entry_points() {
+  std::string log;
+  for (std::string_view sentence :
+       {RMC_VALID, RMC_VOID, GGA_GPS, GGA_RTK, GLL_GLONASS, TXT}) {
+    log += sentence;
+    log += "\r\n";
+  }
+
+  Filter filter;
+  filter.only_types({Type::GGA, Type::RMC}).match(Type::RMC, 2, "A");
+
+  std::size_t handled = 0;
+  std::size_t parsed = cnmea::bulk::parse_buffer(
+      log, filter, [&](const cnmea::Result &result) {
+        handled++;
+        CHECK(result.has_value());
+      });
+  CHECK(parsed == 3 && handled == 3);
+
+  cnmea::StreamParser stream{filter};
+  handled = 0;
+  stream.feed(log, [&](const cnmea::Result &result) {
+    handled++;
+    CHECK(result.has_value());
+  });
+  CHECK(handled == 3);
+  CHECK(stream.filtered_sentences() == 3);
+
+  // Without a filter the unknown type is parsed and reported.
+  cnmea::StreamParser unfiltered;
+  std::size_t errors = 0;
+  unfiltered.feed(log, [&](const cnmea::Result &result) {
+    errors += result ? 0 : 1;
+  });
+  CHECK(errors == 1 && unfiltered.filtered_sentences() == 0);
+}
+
+} // namespace
+
+int main() {
+  default_accepts_everything();
+  types_and_talkers();
+  conditions_on_fields();
+  fewer_fields_than_index();
+  undecodable_header();
+  entry_points();
+  return cnmea::test::result();
+}
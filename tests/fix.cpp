@@ -0,0 +1,193 @@
+#include "check.h"
+
+#include <cnmea/fix.h>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace {
+
+using namespace cnmea::types;
+
+constexpr std::int64_t NS_PER_SECOND{1'000'000'000};
+/// 2025-01-01T00:00:00Z
+constexpr std::int64_t NEW_YEAR_NS{1'735'689'600 * NS_PER_SECOND};
+
+cnmea::GGA gga(UTCTime time, double latitude = 48.5) {
+  return {Type::GGA,
+          Talker::GP,
+          time,
+          Latitude{latitude, Direction::North},
+          Longitude{11.5, Direction::East},
+          FixQuality::GPS,
+          8,
+          0.9,
+          Altitude{545.5},
+          GeoidSeparation{46.5},
+          std::nullopt,
+          std::nullopt};
+}
+
+cnmea::RMC rmc(UTCTime time, std::optional<UTCDate> date) {
+  return {Type::RMC,
+          Talker::GP,
+          time,
+          Status::Valid,
+          Latitude{48.5, Direction::North},
+          Longitude{11.5, Direction::East},
+          Speed{22.5},
+          Course{84.5},
+          date,
+          std::nullopt,
+          Mode::Autonomous};
+}
+
+cnmea::GSA gsa(std::vector<int> prns) {
+  cnmea::GSA data{Type::GSA,       Talker::GP, SelectionMode::Automatic,
+                  FixType::ThreeD, {},         DOP{2.5, 1.5, 2.0}};
+  for (int prn : prns) {
+    data.satellites.push_back(Satellite{prn, 0, 0, 0});
+  }
+  return data;
+}
+
+cnmea::VTG vtg() {
+  return {Type::VTG,   Talker::GP,   Course{90.5}, std::nullopt,
+          Speed{10.5}, std::nullopt, Mode::Differential};
+}
+
+/// A new time closes the epoch and returns it, not the one just started.
+void epoch_boundary() {
+  cnmea::FixAggregator aggregator;
+
+  CHECK(aggregator.push(gga(UTCTime{12, 0, 0, 0}, 10.5)) == nullptr);
+  CHECK(aggregator.push(rmc(UTCTime{12, 0, 0, 0}, std::nullopt)) == nullptr);
+
+  const cnmea::Fix *fix = aggregator.push(gga(UTCTime{12, 0, 1, 0}, 20.5));
+  CHECK(fix != nullptr);
+  if (fix == nullptr) {
+    return;
+  }
+  CHECK(fix->utc_time == UTCTime{12, 0, 0, 0});
+  // RMC's position, merged after GGA's.
+  CHECK(fix->latitude && fix->latitude->get_degrees() == 48.5);
+  CHECK(fix->has(Type::GGA) && fix->has(Type::RMC) && !fix->has(Type::VTG));
+  CHECK(fix->speed == Speed{22.5});
+
+  const cnmea::Fix &current = aggregator.current();
+  CHECK(current.utc_time == UTCTime{12, 0, 1, 0});
+  CHECK(current.latitude && current.latitude->get_degrees() == 20.5);
+  CHECK(current.has(Type::GGA) && !current.has(Type::RMC));
+}
+
+/// GSA and VTG carry no time and join whatever epoch is open, also the
+/// first one before its timed sentence arrives.
+void untimed_sentences() {
+  cnmea::FixAggregator aggregator;
+
+  CHECK(aggregator.push(gsa({4, 5})) == nullptr);
+  CHECK(aggregator.push(vtg()) == nullptr);
+  CHECK(aggregator.push(gga(UTCTime{12, 0, 0, 0})) == nullptr);
+  CHECK(aggregator.push(gsa({9})) == nullptr);
+
+  const cnmea::Fix *fix = aggregator.push(gga(UTCTime{12, 0, 1, 0}));
+  CHECK(fix != nullptr);
+  if (fix == nullptr) {
+    return;
+  }
+  CHECK(fix->utc_time == UTCTime{12, 0, 0, 0});
+  CHECK(fix->has(Type::GSA) && fix->has(Type::VTG) && fix->has(Type::GGA));
+  CHECK(fix->fix_type == FixType::ThreeD);
+  CHECK(fix->course == Course{90.5} && fix->mode == Mode::Differential);
+  // GSA's HDOP wins over GGA's.
+  CHECK(fix->hdop == 1.5);
+  CHECK(fix->used_count == 3 && fix->used()[0] == 4 && fix->used()[2] == 9);
+
+  // Untimed sentences after the boundary belong to the new epoch.
+  CHECK(aggregator.push(vtg()) == nullptr);
+  CHECK(aggregator.current().has(Type::VTG));
+}
+
+void gsv_ignored() {
+  cnmea::FixAggregator aggregator;
+
+  CHECK(aggregator.push(cnmea::GSV{Type::GSV,
+                                   Talker::GP,
+                                   1,
+                                   1,
+                                   1,
+                                   {Satellite{7, 45, 180, 38}}}) == nullptr);
+  CHECK(aggregator.current().sources == 0);
+  CHECK(aggregator.flush() == nullptr);
+}
+
+void flush() {
+  cnmea::FixAggregator aggregator;
+  CHECK(aggregator.flush() == nullptr);
+
+  aggregator.push(gga(UTCTime{12, 0, 0, 0}));
+  const cnmea::Fix *fix = aggregator.flush();
+  CHECK(fix != nullptr && fix->utc_time == UTCTime{12, 0, 0, 0});
+
+  // Nothing merged since.
+  CHECK(aggregator.flush() == nullptr);
+  CHECK(aggregator.current().sources == 0);
+
+  // A flushed epoch is not reported again by the next time change.
+  CHECK(aggregator.push(gga(UTCTime{12, 0, 1, 0})) == nullptr);
+}
+
+/// PRNs beyond Fix::CAPACITY are dropped, not written past the array.
+void used_prns_capped() {
+  cnmea::FixAggregator aggregator;
+  aggregator.push(gga(UTCTime{12, 0, 0, 0}));
+
+  std::vector<int> prns;
+  for (int prn = 1; prn <= 12; prn++) {
+    prns.push_back(prn);
+  }
+  for (int talker = 0; talker < 4; talker++) {
+    aggregator.push(gsa(prns));
+  }
+
+  const cnmea::Fix &fix = aggregator.current();
+  CHECK(fix.used_count == cnmea::Fix::CAPACITY);
+  CHECK(fix.used().size() == cnmea::Fix::CAPACITY);
+  CHECK(fix.used().back() == 12);
+}
+
+/// Epochs are stamped once RMC or ZDA has supplied the date.
+void epoch_ns_from_date() {
+  cnmea::FixAggregator aggregator;
+
+  aggregator.push(gga(UTCTime{0, 0, 1, 0}));
+  CHECK(!aggregator.current().epoch_ns);
+
+  aggregator.push(rmc(UTCTime{0, 0, 1, 0}, UTCDate{1, 1, 2025}));
+  CHECK(aggregator.current().epoch_ns == NEW_YEAR_NS + NS_PER_SECOND);
+  CHECK(aggregator.current().utc_date == UTCDate{1, 1, 2025});
+
+  // Later epochs keep the date.
+  const cnmea::Fix *fix = aggregator.push(gga(UTCTime{0, 0, 2, 0}));
+  CHECK(fix != nullptr && fix->epoch_ns == NEW_YEAR_NS + NS_PER_SECOND);
+  CHECK(aggregator.current().epoch_ns == NEW_YEAR_NS + 2 * NS_PER_SECOND);
+
+  // ZDA supplies the date too, here from the text form.
+  cnmea::FixAggregator zda;
+  auto pushed = zda.push("$GPZDA,000000.50,01,01,2025,00,00*66");
+  CHECK(pushed.has_value() && pushed.value() == nullptr);
+  CHECK(zda.current().epoch_ns == NEW_YEAR_NS + NS_PER_SECOND / 2);
+}
+
+} // namespace
+
+int main() {
+  epoch_boundary();
+  untimed_sentences();
+  gsv_ignored();
+  flush();
+  used_prns_capped();
+  epoch_ns_from_date();
+  return cnmea::test::result();
+}
@@ -0,0 +1,130 @@
+#include "check.h"
+
+#include <cnmea/bulk.h>
+#include <cnmea/parallel.h>
+#include <cstddef>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+/// Valid and broken sentences, with the line endings and noise seen in
+/// real logs.
+constexpr std::string_view LINES[]{
+    "$GPGGA,123519.00,4807.038000,N,01131.000000,E,1,08,0.9,545.4,M,46.9,M,,"
+    "*69\r\n",
+    "$GPRMC,123519.00,A,4807.038000,N,01131.000000,E,22.4,84.4,230394,3.1,W,"
+    "A*29\n",
+    "$GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,06,292,00*74\r\n",
+    "\r\n",
+    "$GPVTG,54.7,T,34.4,M,5.5,N,10.2,K,A*00\r\n",
+    "noise before $GPGLL,4916.450000,S,12311.120000,W,225444.00,A,A*6F\r\n",
+    "$GPZDA,201530.00,04,07,2002,-05,00*48\r\n",
+    "$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39\r\n",
+    "!AIVDM,1,1,,A,13aEOK?P00PD2wVMdLDRhgvL289?,0*26\r\n",
+    "$GPGGA,truncated\r\n",
+};
+
+/// A few thousand lines, with a sentence that changes from line to line
+/// so that reordering shows up in the comparison.
+std::string log() {
+  std::string text;
+  for (int i = 0; i < 4000; i++) {
+    text += LINES[i % std::size(LINES)];
+    if (i % 7 == 0) {
+      text += std::format("$GPZDA,{:02}1530.00,04,07,2002,00,00*00\r\n",
+                          i % 24);
+    }
+  }
+  return text;
+}
+
+std::vector<cnmea::Result> collect(std::string_view text,
+                                   const cnmea::parallel::Options &options,
+                                   std::size_t &count) {
+  std::vector<cnmea::Result> results;
+  count = cnmea::parallel::parse_buffer(
+      text, options,
+      [&](const cnmea::Result &result) { results.push_back(result); });
+  return results;
+}
+
+/// Chunks end at sentence boundaries and cover the buffer exactly.
+void chunks_cover_buffer(std::string_view text) {
+  for (std::size_t chunk_size : {1, 13, 100, 4096}) {
+    auto chunks = cnmea::parallel::split_chunks(text, chunk_size);
+
+    std::size_t covered = 0;
+    for (std::string_view chunk : chunks) {
+      CHECK(chunk.data() == text.data() + covered);
+      CHECK(covered == 0 || chunk.front() == '$' || chunk.front() == '!');
+      covered += chunk.size();
+    }
+    CHECK(covered == text.size());
+  }
+}
+
+/// Ordered results equal the sequential ones element by element, for
+/// chunks far smaller than a sentence up to chunks of many sentences.
+void ordered_matches_sequential(std::string_view text) {
+  std::vector<cnmea::Result> expected;
+  cnmea::bulk::parse_buffer(text, std::back_inserter(expected));
+
+  for (std::size_t threads : {1, 2, 4, 8}) {
+    for (std::size_t chunk_size : {1, 13, 100, 4096}) {
+      for (bool arenas : {true, false}) {
+        std::size_t count = 0;
+        auto results =
+            collect(text, {threads, chunk_size, true, arenas, {}}, count);
+        CHECK(count == expected.size());
+        CHECK(results == expected);
+      }
+    }
+  }
+}
+
+/// Unordered results hold the same sentences, each exactly once.
+void unordered_loses_nothing(std::string_view text) {
+  std::size_t expected = cnmea::bulk::parse_buffer(text, [](const auto &) {});
+
+  for (std::size_t threads : {2, 8}) {
+    std::size_t count = 0;
+    auto results = collect(text, {threads, 13, false, true, {}}, count);
+    CHECK(count == expected && results.size() == expected);
+  }
+}
+
+#if defined(__cpp_exceptions)
+/// A throwing handler stops the parse instead of leaving workers waiting
+/// for a window that never opens.
+void handler_exception_releases_workers(std::string_view text) {
+  std::size_t delivered = 0;
+  bool thrown = false;
+  try {
+    cnmea::parallel::parse_buffer(text, {4, 13, true, true, {}},
+                                  [&](const cnmea::Result &) {
+                                    if (++delivered == 100) {
+                                      throw delivered;
+                                    }
+                                  });
+  } catch (std::size_t) {
+    thrown = true;
+  }
+  CHECK(thrown && delivered == 100);
+}
+#endif
+
+} // namespace
+
+int main() {
+  const std::string text = log();
+  chunks_cover_buffer(text);
+  ordered_matches_sequential(text);
+  unordered_loses_nothing(text);
+#if defined(__cpp_exceptions)
+  handler_exception_releases_workers(text);
+#endif
+  return cnmea::test::result();
+}
@@ -0,0 +1,298 @@
+#include "check.h"
+
+#include <atomic>
+#include <chrono>
+#include <cnmea/pipeline.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+using cnmea::pipeline::Overflow;
+using cnmea::pipeline::SpscRing;
+
+/// Owning elements, so that a slot destroyed twice or never shows up under
+/// a sanitizer.
+using Item = std::unique_ptr<std::uint64_t>;
+
+/// Pushes 0, 1, 2, ... through a small ring from a producer that yields
+/// now and then to a consumer that stalls, so that the ring runs full and
+/// empty many times.
+void threads_with_policy(Overflow overflow) {
+  constexpr std::uint64_t PUSHED{200'000};
+  SpscRing<Item> ring{64, overflow};
+
+  std::size_t stored = 0;
+  std::jthread producer{[&] {
+    for (std::uint64_t i = 0; i < PUSHED; i++) {
+      stored += ring.push(std::make_unique<std::uint64_t>(i)) ? 1 : 0;
+      if (i % 64 == 0) {
+        std::this_thread::yield();
+      }
+    }
+    ring.close();
+  }};
+
+  std::size_t delivered = 0;
+  std::optional<std::uint64_t> last;
+  bool in_order = true;
+  cnmea::pipeline::Backoff backoff;
+
+  while (!ring.done()) {
+    std::size_t taken = ring.pop_batch(
+        [&](Item &&item) {
+          in_order &= !last || *item > last.value();
+          last = *item;
+          if (++delivered % 4096 == 0) {
+            std::this_thread::sleep_for(100us);
+          }
+        },
+        256);
+    if (taken == 0) {
+      backoff.wait();
+    } else {
+      backoff.reset();
+    }
+  }
+  producer.join();
+
+  CHECK(in_order);
+  CHECK(delivered + ring.dropped() == PUSHED);
+  CHECK(!ring.pop().has_value());
+
+  switch (overflow) {
+  case Overflow::Block:
+    CHECK(ring.dropped() == 0 && stored == PUSHED);
+    CHECK(last == PUSHED - 1);
+    break;
+  case Overflow::DropNewest:
+    CHECK(stored == delivered);
+    break;
+  case Overflow::DropOldest:
+    // The newest element always survives.
+    CHECK(stored == PUSHED && last == PUSHED - 1);
+    break;
+  }
+}
+
+/// Counts live instances. Moving is slow, which widens the window in
+/// which a DropOldest producer holds a slot, and can run a hook at that
+/// moment.
+struct Slow {
+  static inline std::atomic<long> live{0};
+  static inline std::function<void()> on_move;
+  std::uint64_t value;
+
+  explicit Slow(std::uint64_t value) : value(value) { live++; }
+  Slow(Slow &&other) noexcept : value(other.value) {
+    if (auto hook = std::exchange(on_move, nullptr)) {
+      hook();
+    }
+    auto until = std::chrono::steady_clock::now() + 1us;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+    live++;
+  }
+  Slow &operator=(Slow &&) = default;
+  ~Slow() { live--; }
+};
+
+/// The consumer reaches the element the producer is writing over a dropped
+/// one; it must wait for it, not skip it.
+void drop_oldest_consumer_catches_up() {
+  std::vector<std::uint64_t> delivered;
+  auto take = [&](Slow &&slow) { delivered.push_back(slow.value); };
+  {
+    SpscRing<Slow> ring{2, Overflow::DropOldest};
+    CHECK(ring.push(Slow{0}) && ring.push(Slow{1}));
+
+    // Runs while the producer holds the slot of element 0 to store 2.
+    Slow::on_move = [&] {
+      ring.pop_batch(take);
+      ring.pop_batch(take);
+    };
+    CHECK(ring.push(Slow{2}));
+    ring.close();
+
+    while (!ring.done()) {
+      ring.pop_batch(take);
+    }
+    CHECK(ring.dropped() == 1);
+  }
+  CHECK((delivered == std::vector<std::uint64_t>{1, 2}));
+  CHECK(Slow::live == 0);
+}
+
+/// The same race between threads, on the smallest ring.
+void drop_oldest_small_ring() {
+  constexpr std::size_t RUNS{20'000};
+  constexpr std::size_t PUSHED{8};
+  std::size_t lost_runs = 0;
+
+  for (std::size_t run = 0; run < RUNS; run++) {
+    std::size_t delivered = 0;
+    std::size_t dropped = 0;
+    {
+      SpscRing<Slow> ring{2, Overflow::DropOldest};
+      std::jthread producer{[&] {
+        for (std::uint64_t i = 0; i < PUSHED; i++) {
+          ring.push(Slow{i});
+        }
+        ring.close();
+      }};
+
+      cnmea::pipeline::Backoff backoff;
+      while (!ring.done()) {
+        if (std::size_t taken = ring.pop_batch([](Slow &&) {})) {
+          delivered += taken;
+          backoff.reset();
+        } else {
+          backoff.wait();
+        }
+      }
+      producer.join();
+      dropped = ring.dropped();
+    }
+    lost_runs += delivered + dropped == PUSHED ? 0 : 1;
+  }
+
+  CHECK(lost_runs == 0);
+  CHECK(Slow::live == 0);
+}
+
+void close_and_done() {
+  SpscRing<int> ring{4};
+
+  CHECK(!ring.done());
+  CHECK(ring.push(1) && ring.push(2));
+  ring.close();
+
+  // Elements pushed before close() are still delivered.
+  CHECK(!ring.done());
+  CHECK(ring.pop() == 1);
+  CHECK(!ring.done());
+  CHECK(ring.pop() == 2);
+  CHECK(ring.done());
+  CHECK(!ring.pop().has_value());
+}
+
+void full_ring_policies() {
+  SpscRing<int> newest{2, Overflow::DropNewest};
+  CHECK(newest.push(1) && newest.push(2));
+  CHECK(!newest.push(3));
+  CHECK(newest.dropped() == 1);
+  CHECK(newest.pop() == 1 && newest.pop() == 2);
+
+  SpscRing<int> oldest{2, Overflow::DropOldest};
+  CHECK(oldest.push(1) && oldest.push(2) && oldest.push(3));
+  CHECK(oldest.dropped() == 1);
+  CHECK(oldest.pop() == 2 && oldest.pop() == 3);
+  CHECK(!oldest.pop().has_value());
+}
+
+void stop_releases_blocked_push() {
+  SpscRing<int> ring{2, Overflow::Block};
+  CHECK(ring.push(1) && ring.push(2));
+
+  std::stop_source stop;
+  std::optional<bool> stored;
+  std::jthread producer{[&] { stored = ring.push(3, stop.get_token()); }};
+
+  std::this_thread::sleep_for(20ms);
+  stop.request_stop();
+  producer.join();
+
+  CHECK(stored == false);
+  CHECK(ring.dropped() == 0);
+  CHECK(ring.pop() == 1 && ring.pop() == 2);
+  CHECK(!ring.pop().has_value());
+}
+
+/// Reader, parser and consumer stages over a pipe. A drop policy on the
+/// byte ring loses sentences but never garbles them.
+void stages_over_pipe(Overflow overflow) {
+  constexpr std::string_view SENTENCE{
+      "$GPGLL,4916.45,N,12311.12,W,225444,A,*1D\r\n"};
+  constexpr std::size_t SENTENCES{20'000};
+
+  int fds[2];
+  CHECK(::pipe(fds) == 0);
+
+  SpscRing<cnmea::pipeline::Chunk> bytes{4, overflow};
+  SpscRing<cnmea::Sample> samples{256};
+  std::size_t read = 0;
+  std::size_t errors = 0;
+  std::size_t consumed = 0;
+  std::size_t gll = 0;
+
+  {
+    std::jthread writer{[&] {
+      std::string text;
+      for (std::size_t i = 0; i < SENTENCES; i++) {
+        text += SENTENCE;
+      }
+      for (std::string_view rest = text; !rest.empty();) {
+        ssize_t n = ::write(fds[1], rest.data(), rest.size());
+        if (n <= 0) {
+          break;
+        }
+        rest.remove_prefix(static_cast<std::size_t>(n));
+      }
+      ::close(fds[1]);
+    }};
+
+    auto reader = cnmea::pipeline::spawn(
+        std::nullopt, [&](std::stop_token stop) {
+          read = cnmea::pipeline::read_stage(fds[0], bytes, stop);
+        });
+    auto parser = cnmea::pipeline::spawn(
+        std::nullopt, [&](std::stop_token stop) {
+          errors = cnmea::pipeline::parse_stage(bytes, samples, stop);
+        });
+    consumed = cnmea::pipeline::consume_stage(
+        samples,
+        [&gll](cnmea::Sample &&sample) {
+          gll += std::holds_alternative<cnmea::GLL>(sample) ? 1 : 0;
+        },
+        {});
+  }
+  ::close(fds[0]);
+
+  CHECK(read == SENTENCES * SENTENCE.size());
+  CHECK(errors == 0);
+  CHECK(gll == consumed);
+  if (overflow == Overflow::Block) {
+    CHECK(consumed == SENTENCES && bytes.dropped() == 0);
+  } else {
+    CHECK(consumed <= SENTENCES);
+  }
+}
+
+} // namespace
+
+int main() {
+  threads_with_policy(Overflow::Block);
+  threads_with_policy(Overflow::DropNewest);
+  threads_with_policy(Overflow::DropOldest);
+  drop_oldest_consumer_catches_up();
+  drop_oldest_small_ring();
+  close_and_done();
+  full_ring_policies();
+  stop_releases_blocked_push();
+  stages_over_pipe(Overflow::Block);
+  stages_over_pipe(Overflow::DropNewest);
+  stages_over_pipe(Overflow::DropOldest);
+  return cnmea::test::result();
+}
@@ -0,0 +1,329 @@
+#include "check.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cnmea/cnmea.h>
+#include <cnmea/reactor.h>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/// A GLL sentence whose time of day is @p second seconds after midnight.
+std::string sentence(int second) {
+  cnmea::GLL gll{cnmea::types::Type::GLL,
+                 cnmea::types::Talker::GP,
+                 std::nullopt,
+                 std::nullopt,
+                 cnmea::types::UTCTime{
+                     static_cast<std::uint8_t>(second / 3600),
+                     static_cast<std::uint8_t>(second / 60 % 60),
+                     static_cast<std::uint8_t>(second % 60), 0},
+                 cnmea::types::Status::Valid,
+                 std::nullopt};
+  std::array<char, cnmea::serialize::MAX_LENGTH> buffer;
+  auto length = cnmea::encode(gll, buffer);
+  return {buffer.data(), length.value_or(0)};
+}
+
+/// The time of day of a GLL result in seconds, or -1.
+int second_of(const cnmea::Result &result) {
+  if (!result || !std::holds_alternative<cnmea::GLL>(result.value())) {
+    return -1;
+  }
+  const auto &time = std::get<cnmea::GLL>(result.value()).utc_time;
+  return time ? static_cast<int>(time->to_duration() / 1s) : -1;
+}
+
+void write_all(int fd, std::string_view text) {
+  while (!text.empty()) {
+    ssize_t n = ::write(fd, text.data(), text.size());
+    CHECK(n > 0);
+    if (n <= 0) {
+      return;
+    }
+    text.remove_prefix(static_cast<std::size_t>(n));
+  }
+}
+
+/// Descriptors of a pipe; the read end goes to the reactor.
+std::pair<int, int> make_pipe() {
+  int fds[2];
+  CHECK(::pipe(fds) == 0);
+  return {fds[0], fds[1]};
+}
+
+/// Connected stream sockets; the first goes to the reactor.
+std::pair<int, int> make_socketpair() {
+  int fds[2];
+  CHECK(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+  return {fds[0], fds[1]};
+}
+
+/// Waits up to a few seconds for @p done.
+template <typename Predicate> bool eventually(Predicate done) {
+  auto deadline = std::chrono::steady_clock::now() + 5s;
+  while (!done()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(1ms);
+  }
+  return true;
+}
+
+/// Records every result and every closed source.
+struct Recorder {
+  std::vector<std::pair<cnmea::SourceId, int>> seconds;
+  std::vector<cnmea::SourceId> closed;
+
+  void operator()(cnmea::SourceId id, const cnmea::Result &result) {
+    seconds.emplace_back(id, second_of(result));
+  }
+  void operator()(cnmea::SourceId id) { closed.push_back(id); }
+};
+
+void split_across_writes() {
+  auto reactor = cnmea::Reactor::create();
+  CHECK(reactor.has_value());
+  auto [in, out] = make_pipe();
+  CHECK(reactor->add(in, 7).has_value());
+
+  std::string text = sentence(61);
+  Recorder recorder;
+
+  write_all(out, std::string_view{text}.substr(0, 10));
+  CHECK(reactor->poll(recorder, 1000).has_value());
+  CHECK(recorder.seconds.empty());
+
+  write_all(out, std::string_view{text}.substr(10));
+  CHECK(reactor->poll(recorder, 1000).has_value());
+  CHECK(recorder.seconds ==
+        std::vector<std::pair<cnmea::SourceId, int>>{{7, 61}});
+  CHECK(reactor->stats(7).has_value() && reactor->stats(7)->bytes ==
+                                             text.size() &&
+        reactor->stats(7)->sentences == 1 && reactor->stats(7)->errors == 0);
+
+  ::close(out);
+}
+
+void end_of_file_flushes() {
+  auto reactor = cnmea::Reactor::create();
+  CHECK(reactor.has_value());
+  auto [in, out] = make_socketpair();
+  CHECK(reactor->add(in, 3).has_value());
+
+  // No line ending: only the end of file completes the sentence.
+  std::string text = sentence(5);
+  text.resize(text.size() - 2);
+  write_all(out, text);
+  ::close(out);
+
+  Recorder recorder;
+  CHECK(eventually([&] {
+    CHECK(reactor->poll(recorder, 10).has_value());
+    return !recorder.closed.empty();
+  }));
+  CHECK(recorder.seconds ==
+        std::vector<std::pair<cnmea::SourceId, int>>{{3, 5}});
+  CHECK(recorder.closed == std::vector<cnmea::SourceId>{3});
+  CHECK(reactor->size() == 0);
+  CHECK(!reactor->stats(3).has_value());
+}
+
+void remove_during_batch() {
+  auto reactor = cnmea::Reactor::create();
+  CHECK(reactor.has_value());
+  auto [in_a, out_a] = make_socketpair();
+  auto [in_b, out_b] = make_socketpair();
+  CHECK(reactor->add(in_a, 1).has_value());
+  CHECK(reactor->add(in_b, 2).has_value());
+
+  // Both are readable before the poll, so they arrive in one batch.
+  write_all(out_a, sentence(1) + sentence(2));
+  write_all(out_b, sentence(1) + sentence(2));
+
+  std::vector<std::pair<cnmea::SourceId, int>> seen;
+  std::optional<cnmea::SourceId> removed;
+  auto handler = [&](cnmea::SourceId id, const cnmea::Result &result) {
+    seen.emplace_back(id, second_of(result));
+    if (!removed) {
+      removed = id == 1 ? 2 : 1;
+      CHECK(reactor->remove(removed.value()));
+    }
+  };
+
+  CHECK(reactor->poll(handler, 1000).has_value());
+  CHECK(removed.has_value());
+  if (!removed) {
+    return;
+  }
+
+  // The source read first is delivered in full, the removed one not at
+  // all, although its event was still pending in the batch.
+  cnmea::SourceId kept = removed.value() == 1 ? 2 : 1;
+  CHECK(seen == std::vector<std::pair<cnmea::SourceId, int>>{{kept, 1},
+                                                             {kept, 2}});
+  CHECK(reactor->size() == 1);
+  CHECK(!reactor->remove(removed.value()));
+
+  // A source removed by its own handler stops being read.
+  write_all(kept == 1 ? out_a : out_b, sentence(3));
+  seen.clear();
+  auto remove_self = [&](cnmea::SourceId id, const cnmea::Result &result) {
+    seen.emplace_back(id, second_of(result));
+    reactor->remove(id);
+  };
+  CHECK(reactor->poll(remove_self, 1000).has_value());
+  CHECK(seen == std::vector<std::pair<cnmea::SourceId, int>>{{kept, 3}});
+  CHECK(reactor->size() == 0);
+  CHECK(reactor->poll(remove_self, 0).has_value());
+
+  ::close(out_a);
+  ::close(out_b);
+}
+
+void add_while_running() {
+  auto reactor = cnmea::Reactor::create();
+  CHECK(reactor.has_value());
+
+  std::atomic<int> delivered{0};
+  auto handler = [&](cnmea::SourceId, const cnmea::Result &result) {
+    if (second_of(result) == 42) {
+      delivered++;
+    }
+  };
+
+  std::jthread poller{[&](std::stop_token stop) {
+    CHECK(reactor->run(handler, stop).has_value());
+  }};
+
+  constexpr int SOURCES{8};
+  std::vector<int> writers;
+  for (int id = 0; id < SOURCES; id++) {
+    auto [in, out] = make_socketpair();
+    CHECK(reactor->add(in, static_cast<cnmea::SourceId>(id)).has_value());
+    write_all(out, sentence(42));
+    writers.push_back(out);
+  }
+
+  CHECK(eventually([&] { return delivered == SOURCES; }));
+  CHECK(!reactor->add(writers.front(), 0).has_value());
+
+  poller.request_stop();
+  poller.join();
+  CHECK(reactor->size() == SOURCES);
+
+  for (int fd : writers) {
+    ::close(fd);
+  }
+}
+
+void pool_shards_by_id() {
+  auto pool = cnmea::ReactorPool::create(3);
+  CHECK(pool.has_value() && pool->threads() == 3);
+
+  std::mutex mutex;
+  std::map<cnmea::SourceId, std::vector<int>> seconds;
+  std::map<cnmea::SourceId, std::thread::id> threads;
+  bool one_thread_per_source = true;
+
+  auto handler = [&](cnmea::SourceId id, const cnmea::Result &result) {
+    std::scoped_lock lock{mutex};
+    seconds[id].push_back(second_of(result));
+    auto [it, inserted] = threads.emplace(id, std::this_thread::get_id());
+    one_thread_per_source &= it->second == std::this_thread::get_id();
+  };
+  pool->start(handler);
+
+  constexpr cnmea::SourceId SOURCES{9};
+  constexpr int SENTENCES{50};
+  std::vector<int> writers;
+  for (cnmea::SourceId id = 0; id < SOURCES; id++) {
+    auto [in, out] = make_pipe();
+    CHECK(pool->add(in, id).has_value());
+    writers.push_back(out);
+  }
+  for (int second = 0; second < SENTENCES; second++) {
+    for (int out : writers) {
+      write_all(out, sentence(second));
+    }
+  }
+
+  CHECK(eventually([&] {
+    std::scoped_lock lock{mutex};
+    std::size_t total = 0;
+    for (const auto &[id, list] : seconds) {
+      total += list.size();
+    }
+    return total == SOURCES * SENTENCES;
+  }));
+  pool->stop();
+  CHECK(pool->size() == SOURCES);
+
+  std::vector<int> in_order(SENTENCES);
+  for (int second = 0; second < SENTENCES; second++) {
+    in_order[second] = second;
+  }
+
+  CHECK(one_thread_per_source);
+  for (cnmea::SourceId id = 0; id < SOURCES; id++) {
+    CHECK(seconds[id] == in_order);
+    // Same thread exactly when the same shard.
+    for (cnmea::SourceId other = 0; other < SOURCES; other++) {
+      CHECK((threads[id] == threads[other]) == (id % 3 == other % 3));
+    }
+  }
+
+  for (int fd : writers) {
+    ::close(fd);
+  }
+}
+
+/// Assigning over a running pool stops its threads before its reactors
+/// go, and the threads taken over keep polling.
+void pool_move_assignment() {
+  auto pool = cnmea::ReactorPool::create(2);
+  auto other = cnmea::ReactorPool::create(3);
+  CHECK(pool.has_value() && other.has_value());
+
+  std::atomic<int> received{0};
+  auto handler = [&](cnmea::SourceId, const cnmea::Result &) { received++; };
+  pool->start(handler);
+  other->start(handler);
+
+  auto [in, out] = make_pipe();
+  CHECK(other->add(in, 4).has_value());
+
+  pool.value() = std::move(other.value());
+  CHECK(pool->threads() == 3 && pool->size() == 1);
+
+  write_all(out, sentence(0));
+  CHECK(eventually([&] { return received == 1; }));
+  pool->stop();
+  ::close(out);
+}
+
+} // namespace
+
+int main() {
+  split_across_writes();
+  end_of_file_flushes();
+  remove_during_batch();
+  add_while_running();
+  pool_shards_by_id();
+  pool_move_assignment();
+  return cnmea::test::result();
+}
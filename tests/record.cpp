@@ -0,0 +1,197 @@
+#include "check.h"
+
+#include <cmath>
+#include <cnmea/record.h>
+#include <cstddef>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <system_error>
+#include <variant>
+#include <vector>
+
+namespace {
+
+using namespace cnmea::types;
+
+constexpr double MISSING{std::numeric_limits<double>::quiet_NaN()};
+
+/// Measurements other than coordinates are stored in single precision.
+bool close(double a, double b) {
+  return std::fabs(a - b) <= 1e-6 * std::fmax(std::fabs(a), std::fabs(b));
+}
+
+/// Samples whose values are exact in single precision, so that they come
+/// back from a record unchanged.
+std::vector<cnmea::Sample> exact_samples() {
+  std::vector<cnmea::Sample> samples;
+  samples.emplace_back(cnmea::GGA{Type::GGA,
+                                  Talker::GN,
+                                  UTCTime{23, 59, 59, 500'000'000},
+                                  Latitude{33.75, Direction::South},
+                                  Longitude{70.5, Direction::West},
+                                  FixQuality::DGPS,
+                                  9,
+                                  1.25,
+                                  Altitude{-12.5, DistanceUnits::ft},
+                                  GeoidSeparation{-30.25},
+                                  AgeOfDgps{2.5},
+                                  DgpsStationId{17}});
+  samples.emplace_back(cnmea::GGA{Type::GGA, Talker::GP, std::nullopt,
+                                  std::nullopt, std::nullopt,
+                                  FixQuality::Invalid, 0, 0.0, std::nullopt,
+                                  std::nullopt, std::nullopt, std::nullopt});
+  samples.emplace_back(cnmea::GLL{Type::GLL, Talker::GA,
+                                  Latitude{0.5, Direction::South},
+                                  Longitude{179.25, Direction::West},
+                                  UTCTime{0, 0, 0, 0}, Status::Valid,
+                                  Mode::Differential});
+  samples.emplace_back(cnmea::GSA{Type::GSA,
+                                  Talker::GN,
+                                  SelectionMode::Automatic,
+                                  FixType::ThreeD,
+                                  {Satellite{1, MISSING, MISSING, MISSING},
+                                   Satellite{32, MISSING, MISSING, MISSING}},
+                                  DOP{1.5, 0.75, 1.25}});
+  samples.emplace_back(cnmea::GSV{Type::GSV,
+                                  Talker::GL,
+                                  2,
+                                  2,
+                                  5,
+                                  {Satellite{70, 45, 180, 38},
+                                   Satellite{71, 4.5, MISSING, MISSING}}});
+  samples.emplace_back(cnmea::RMC{Type::RMC,
+                                  Talker::GP,
+                                  UTCTime{12, 0, 0, 0},
+                                  Status::Valid,
+                                  Latitude{45.5, Direction::North},
+                                  Longitude{120.75, Direction::East},
+                                  Speed{3.5},
+                                  Course{270.5},
+                                  UTCDate{29, 2, 2024},
+                                  MagneticVariation{4.5, Direction::West},
+                                  Mode::Autonomous});
+  samples.emplace_back(cnmea::VTG{Type::VTG, Talker::GN, Course{359.5},
+                                  std::nullopt, Speed{10.5, SpeedUnits::knots},
+                                  Speed{19.5, SpeedUnits::kmh},
+                                  Mode::Estimated});
+  samples.emplace_back(cnmea::ZDA{Type::ZDA, Talker::GP, UTCTime{1, 2, 3, 0},
+                                  31, 12, 2025, -11, 30});
+  return samples;
+}
+
+void exact_round_trip() {
+  for (const cnmea::Sample &sample : exact_samples()) {
+    auto decoded = cnmea::record::decode(cnmea::record::encode(sample));
+    CHECK(decoded.has_value() && decoded.value() == sample);
+  }
+}
+
+/// Units are kept; values come back within single precision.
+void units_and_precision() {
+  auto parsed = cnmea::parse(
+      "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,FT,46.9,KM,,*53");
+  CHECK(parsed.has_value());
+  if (!parsed) {
+    return;
+  }
+  const auto &gga = std::get<cnmea::GGA>(parsed.value());
+
+  auto decoded = cnmea::record::decode(cnmea::record::encode(gga));
+  CHECK(decoded.has_value() &&
+        std::holds_alternative<cnmea::GGA>(decoded.value()));
+  if (!decoded || !std::holds_alternative<cnmea::GGA>(decoded.value())) {
+    return;
+  }
+  const auto &out = std::get<cnmea::GGA>(decoded.value());
+
+  CHECK(out.latitude == gga.latitude && out.longitude == gga.longitude);
+  CHECK(out.altitude && out.altitude->get_units() == DistanceUnits::ft);
+  CHECK(out.geoid_separation &&
+        out.geoid_separation->get_units() == DistanceUnits::km);
+  CHECK(out.altitude && close(out.altitude->get_value(), 545.4));
+  CHECK(out.geoid_separation &&
+        close(out.geoid_separation->get_value(), 46.9));
+  CHECK(close(out.hdop, 0.9));
+}
+
+/// Enumeration bytes out of range are reported, not cast.
+void corrupt_bytes() {
+  using cnmea::record::decode;
+  using cnmea::record::encode;
+  std::vector<cnmea::Sample> samples = exact_samples();
+
+  cnmea::record::Record record = encode(samples[0]);
+  record.type_id = 7;
+  CHECK(record.type().error() == ParseError::UnsupportedType);
+  CHECK(decode(record).error() == ParseError::UnsupportedType);
+
+  record = encode(samples[0]);
+  record.talker_id = 8;
+  CHECK(record.talker().error() == ParseError::InvalidFormat);
+  CHECK(decode(record).error() == ParseError::InvalidFormat);
+
+  record = encode(samples[0]);
+  record.gga.fix_quality = 9;
+  CHECK(decode(record).error() == ParseError::InvalidFixQuality);
+
+  record = encode(samples[0]);
+  record.gga.altitude_units = 3;
+  CHECK(decode(record).error() == ParseError::UnsupportedType);
+
+  record = encode(samples[2]);
+  record.gll.status = 2;
+  CHECK(decode(record).error() == ParseError::InvalidStatus);
+
+  record = encode(samples[2]);
+  record.gll.mode = 10;
+  CHECK(decode(record).error() == ParseError::InvalidMode);
+  // A mode byte is only read when the mode is present.
+  record.presence &= ~cnmea::record::GLLData::MODE;
+  CHECK(decode(record).has_value());
+
+  record = encode(samples[3]);
+  record.gsa.selection_mode = 2;
+  CHECK(decode(record).error() == ParseError::InvalidSelectionMode);
+
+  record = encode(samples[3]);
+  record.gsa.fix_type = 3;
+  CHECK(decode(record).error() == ParseError::InvalidFixType);
+}
+
+void file_round_trip() {
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() / "cnmea_test_record.cnr";
+  std::vector<cnmea::Sample> samples = exact_samples();
+
+  auto writer = cnmea::record::Writer::create(path);
+  CHECK(writer.has_value());
+  if (!writer) {
+    return;
+  }
+  for (const cnmea::Sample &sample : samples) {
+    writer->write(sample);
+  }
+  CHECK(writer->close().has_value());
+
+  auto reader = cnmea::record::Reader::open(path);
+  CHECK(reader.has_value() && reader->size() == samples.size());
+  for (std::size_t i = 0; reader && i < reader->size() && i < samples.size();
+       i++) {
+    auto decoded = reader->read(i);
+    CHECK(decoded.has_value() && decoded.value() == samples[i]);
+  }
+
+  std::error_code error;
+  std::filesystem::remove(path, error);
+}
+
+} // namespace
+
+int main() {
+  exact_round_trip();
+  units_and_precision();
+  corrupt_bytes();
+  file_round_trip();
+  return cnmea::test::result();
+}
@@ -0,0 +1,128 @@
+#include "check.h"
+
+#include <array>
+#include <cnmea/cnmea.h>
+#include <cnmea/replay.h>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using cnmea::types::UTCTime;
+
+constexpr std::int64_t MS{1'000'000};
+constexpr std::int64_t SECOND{1'000 * MS};
+
+/// A sentence without a time.
+constexpr std::string_view VTG{"$GPVTG,54.7,T,34.4,M,5.5,N,10.2,K,A*15\r\n"};
+
+/// A GLL sentence sent at @p time.
+std::string gll(UTCTime time) {
+  cnmea::GLL data{cnmea::types::Type::GLL,
+                  cnmea::types::Talker::GP,
+                  std::nullopt,
+                  std::nullopt,
+                  time,
+                  cnmea::types::Status::Valid,
+                  std::nullopt};
+  std::array<char, cnmea::serialize::MAX_LENGTH> buffer;
+  auto length = cnmea::encode(data, buffer);
+  CHECK(length.has_value());
+  return {buffer.data(), length.value_or(0)};
+}
+
+std::string join(std::initializer_list<std::string_view> sentences) {
+  std::string log;
+  for (std::string_view sentence : sentences) {
+    log += sentence;
+  }
+  return log;
+}
+
+/// Offsets and sentence counts of every epoch, and that the epochs cover
+/// the log back to back.
+void check_epochs(const cnmea::replay::Schedule &schedule,
+                  std::string_view log,
+                  const std::vector<std::int64_t> &offsets,
+                  const std::vector<std::size_t> &sentences) {
+  auto epochs = schedule.epochs();
+  CHECK(epochs.size() == offsets.size());
+  if (epochs.size() != offsets.size()) {
+    return;
+  }
+
+  std::string covered;
+  for (std::size_t i = 0; i < epochs.size(); i++) {
+    CHECK(epochs[i].offset_ns == offsets[i]);
+    CHECK(epochs[i].sentences == sentences[i]);
+    covered += schedule.bytes(epochs[i]);
+  }
+  CHECK(covered == log);
+}
+
+/// Untimed sentences join the epoch in progress, and those before the
+/// first timed sentence join the first epoch.
+void untimed_sentences() {
+  const std::string t0 = gll(UTCTime{12, 0, 0, 0});
+  const std::string t1 = gll(UTCTime{12, 0, 1, 0});
+  const std::string log = join({VTG, VTG, t0, VTG, t0, t1, VTG});
+
+  cnmea::replay::Schedule schedule{log};
+  check_epochs(schedule, log, {0, SECOND}, {5, 2});
+  CHECK(schedule.sentences() == 7);
+
+  // A log without any time is a single epoch.
+  const std::string untimed = join({VTG, VTG});
+  check_epochs(cnmea::replay::Schedule{untimed}, untimed, {0}, {2});
+}
+
+/// Crossing midnight adds a day instead of jumping back 24 hours.
+void midnight_rollover() {
+  const std::string log = join({gll(UTCTime{23, 59, 59, 0}),
+                                gll(UTCTime{0, 0, 0, 0}),
+                                gll(UTCTime{0, 0, 1, 0})});
+  cnmea::replay::Schedule schedule{log};
+  check_epochs(schedule, log, {0, SECOND, 2 * SECOND}, {1, 1, 1});
+  CHECK(schedule.duration_ns() == 2 * SECOND);
+}
+
+/// A time going backwards replays right away: offsets never decrease.
+void backward_jump() {
+  const std::string log = join({gll(UTCTime{12, 0, 0, 0}),
+                                gll(UTCTime{12, 0, 5, 0}),
+                                gll(UTCTime{12, 0, 2, 0}),
+                                gll(UTCTime{12, 0, 6, 0})});
+  cnmea::replay::Schedule schedule{log};
+  check_epochs(schedule, log, {0, 5 * SECOND, 5 * SECOND, 6 * SECOND},
+               {1, 1, 1, 1});
+}
+
+void period() {
+  // One second when there is nothing to estimate it from.
+  CHECK(cnmea::replay::Schedule{""}.period_ns() == SECOND);
+  const std::string single = join({gll(UTCTime{12, 0, 0, 0}), VTG});
+  CHECK(cnmea::replay::Schedule{single}.period_ns() == SECOND);
+
+  std::string log;
+  for (std::uint32_t i = 0; i < 5; i++) {
+    log += gll(UTCTime{12, 0, 0, i * 200'000'000});
+  }
+  cnmea::replay::Schedule schedule{log};
+  CHECK(schedule.epochs().size() == 5);
+  CHECK(schedule.duration_ns() == 800 * MS);
+  CHECK(schedule.period_ns() == 200 * MS);
+}
+
+} // namespace
+
+int main() {
+  untimed_sentences();
+  midnight_rollover();
+  backward_jump();
+  period();
+  return cnmea::test::result();
+}
@@ -0,0 +1,207 @@
+#include "check.h"
+
+#include <array>
+#include <cnmea/cnmea.h>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+
+namespace {
+
+using namespace cnmea::types;
+
+constexpr double MISSING{std::numeric_limits<double>::quiet_NaN()};
+
+/// Sentences as the encoders write them, so encode(parse(s)) == s.
+constexpr std::array CANONICAL{
+    std::string_view{"$GPGGA,123519.00,4807.038000,N,01131.000000,E,1,08,0.9,"
+                     "545.4,M,46.9,M,,*69"},
+    std::string_view{"$GNGGA,062735.00,3150.788156,S,11711.922383,W,2,12,2,"
+                     "-90.5,M,-1.2,M,3.5,0120*44"},
+    std::string_view{"$GPGGA,,,,,,0,00,0,,,,,,*56"},
+    std::string_view{"$GPGLL,4916.450000,S,12311.120000,W,225444.00,A,A*6F"},
+    std::string_view{"$GPGLL,,,,,,V*06"},
+    std::string_view{"$GNGSA,A,3,86,74,85,75,84,,,,,,,,1.96,1.36,1.42*1F"},
+    std::string_view{"$GPGSA,M,1,,,,,,,,,,,,,,,*12"},
+    std::string_view{"$GPGSV,1,1,00*79"},
+    std::string_view{"$GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,"
+                     "13,06,292,00*74"},
+    std::string_view{"$GPGSV,3,2,11,14,25,170,00,16,57,208,39,18,67,296,40,"
+                     "19,40,246,00*74"},
+    std::string_view{"$GPGSV,3,3,11,22,42,067,42,24,14,311,43,27,05,244,*4D"},
+    std::string_view{"$GPRMC,123519.00,A,4807.038000,N,01131.000000,E,22.4,"
+                     "84.4,230394,3.1,W,A*29"},
+    std::string_view{"$GPRMC,235959.50,A,3345.123000,S,07030.456000,W,0,,"
+                     "311224,,,D*65"},
+    std::string_view{"$GPRMC,,V,,,,,,,,,*31"},
+    std::string_view{"$GPVTG,54.7,T,34.4,M,5.5,N,10.2,K,A*15"},
+    std::string_view{"$GPVTG,,T,,M,,N,,K*4E"},
+    std::string_view{"$GPZDA,201530.00,04,07,2002,-05,00*48"},
+    std::string_view{"$GPZDA,201530.00,,,,00,00*63"},
+};
+
+/// Encodes @p sample and parses the result back.
+cnmea::Result reparse(const cnmea::Sample &sample, std::string &text) {
+  std::array<char, cnmea::serialize::MAX_LENGTH> buffer;
+  auto length = cnmea::encode(sample, buffer);
+  CHECK(length.has_value());
+  if (!length) {
+    return std::unexpected(length.error());
+  }
+
+  text.assign(buffer.data(), length.value());
+  CHECK(text.ends_with("\r\n"));
+  return cnmea::parse(std::string_view{text}.substr(0, text.size() - 2));
+}
+
+/// text -> sample -> text is the identity, and so is sample -> text ->
+/// sample.
+void round_trip(std::string_view sentence) {
+  auto parsed = cnmea::parse(sentence);
+  CHECK(parsed.has_value());
+  if (!parsed) {
+    return;
+  }
+
+  std::string text;
+  auto again = reparse(parsed.value(), text);
+  CHECK(text == std::string{sentence} + "\r\n");
+  CHECK(again.has_value() && again.value() == parsed.value());
+}
+
+/// sample -> text -> sample is the identity.
+template <typename T> void round_trip(const T &data) {
+  std::string text;
+  auto parsed = reparse(cnmea::Sample{data}, text);
+  CHECK(parsed.has_value() && std::holds_alternative<T>(parsed.value()) &&
+        std::get<T>(parsed.value()) == data);
+}
+
+void canonical_sentences() {
+  for (std::string_view sentence : CANONICAL) {
+    round_trip(sentence);
+  }
+}
+
+void built_samples() {
+  round_trip(cnmea::GGA{Type::GGA,
+                        Talker::GN,
+                        UTCTime{23, 59, 59, 500'000'000},
+                        Latitude{33.75, Direction::South},
+                        Longitude{70.5, Direction::West},
+                        FixQuality::DGPS,
+                        9,
+                        1.25,
+                        Altitude{-12.5},
+                        GeoidSeparation{-30.25},
+                        AgeOfDgps{2.5},
+                        DgpsStationId{17}});
+  round_trip(cnmea::GGA{Type::GGA, Talker::GP, std::nullopt, std::nullopt,
+                        std::nullopt, FixQuality::Invalid, 0, 0.0,
+                        std::nullopt, std::nullopt, std::nullopt,
+                        std::nullopt});
+
+  round_trip(cnmea::GLL{Type::GLL, Talker::GA, Latitude{0.5, Direction::South},
+                        Longitude{179.25, Direction::West},
+                        UTCTime{0, 0, 0, 0}, Status::Valid,
+                        Mode::Differential});
+  round_trip(cnmea::GLL{Type::GLL, Talker::GP, std::nullopt, std::nullopt,
+                        std::nullopt, Status::Invalid, std::nullopt});
+
+  round_trip(cnmea::GSA{Type::GSA,
+                        Talker::GN,
+                        SelectionMode::Automatic,
+                        FixType::ThreeD,
+                        {Satellite{1, MISSING, MISSING, MISSING},
+                         Satellite{32, MISSING, MISSING, MISSING}},
+                        DOP{1.5, 0.75, 1.25}});
+  round_trip(cnmea::GSA{Type::GSA, Talker::GP, SelectionMode::Manual,
+                        FixType::None, {}, std::nullopt});
+
+  round_trip(cnmea::GSV{Type::GSV,
+                        Talker::GL,
+                        2,
+                        2,
+                        5,
+                        {Satellite{70, 45, 180, 38}}});
+
+  round_trip(cnmea::RMC{Type::RMC,
+                        Talker::GP,
+                        UTCTime{12, 0, 0, 0},
+                        Status::Valid,
+                        Latitude{45.5, Direction::South},
+                        Longitude{120.75, Direction::West},
+                        Speed{3.5},
+                        Course{270.5},
+                        UTCDate{29, 2, 2024},
+                        MagneticVariation{4.5, Direction::West},
+                        Mode::Autonomous});
+  round_trip(cnmea::RMC{Type::RMC, Talker::GP, std::nullopt, Status::Invalid,
+                        std::nullopt, std::nullopt, std::nullopt,
+                        std::nullopt, std::nullopt, std::nullopt,
+                        std::nullopt});
+
+  round_trip(cnmea::VTG{Type::VTG, Talker::GN, Course{359.5}, Course{0.5},
+                        Speed{10.5, SpeedUnits::knots},
+                        Speed{19.5, SpeedUnits::kmh}, Mode::Estimated});
+  round_trip(cnmea::VTG{Type::VTG, Talker::GP, std::nullopt, std::nullopt,
+                        std::nullopt, std::nullopt, std::nullopt});
+
+  round_trip(cnmea::ZDA{Type::ZDA, Talker::GP, UTCTime{1, 2, 3, 0}, 31, 12,
+                        2025, -11, 30});
+  round_trip(cnmea::ZDA{Type::ZDA, Talker::GP, std::nullopt, 0, 0, 0, 0, 0});
+}
+
+/// Values no receiver reports are rejected rather than mangled.
+void out_of_range_values() {
+  std::array<char, cnmea::serialize::MAX_LENGTH> buffer;
+  auto length = cnmea::encode(
+      cnmea::GGA{Type::GGA, Talker::GP, std::nullopt, std::nullopt,
+                 std::nullopt, FixQuality::GPS, 8, 1.0, Altitude{1e300},
+                 std::nullopt, std::nullopt, std::nullopt},
+      buffer);
+  CHECK(!length && length.error() == ParseError::BufferOverflow);
+
+  constexpr double INF{std::numeric_limits<double>::infinity()};
+
+  // Satellite measures beyond long long or infinite.
+  length = cnmea::encode(
+      cnmea::GSV{Type::GSV, Talker::GP, 1, 1, 1, {Satellite{7, 1e19, 90, 40}}},
+      buffer);
+  CHECK(length.has_value() &&
+        std::string_view{buffer.data(), length.value()}.contains(
+            ",10000000000000000000,"));
+  length = cnmea::encode(
+      cnmea::GSV{Type::GSV, Talker::GP, 1, 1, 1, {Satellite{7, -INF, 90, 40}}},
+      buffer);
+  CHECK(!length && length.error() == ParseError::BufferOverflow);
+
+  // Coordinates that are not finite or out of range.
+  for (double degrees : {INF, -INF, MISSING, 1e20, 90.5}) {
+    length = cnmea::encode(cnmea::GLL{Type::GLL, Talker::GP,
+                                      Latitude{degrees, Direction::North},
+                                      std::nullopt, std::nullopt,
+                                      Status::Valid, std::nullopt},
+                           buffer);
+    CHECK(!length && length.error() == ParseError::InvalidLatitude);
+  }
+  for (double degrees : {INF, MISSING, 1e300, 180.5}) {
+    length = cnmea::encode(cnmea::GLL{Type::GLL, Talker::GP, std::nullopt,
+                                      Longitude{degrees, Direction::East},
+                                      std::nullopt, Status::Valid,
+                                      std::nullopt},
+                           buffer);
+    CHECK(!length && length.error() == ParseError::InvalidLongitude);
+  }
+}
+
+} // namespace
+
+int main() {
+  canonical_sentences();
+  built_samples();
+  out_of_range_values();
+  return cnmea::test::result();
+}
@@ -0,0 +1,102 @@
+#include "check.h"
+
+#include <cnmea/tools.h>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace {
+
+using cnmea::types::ParseError;
+
+constexpr std::string_view TXT{"$GPTXT,01,01,02,hello*2F"};
+
+/// Appends the checksum of @p sentence, which starts with `$`.
+std::string with_checksum(std::string sentence) {
+  std::uint8_t check = 0;
+  for (char c : std::string_view{sentence}.substr(1)) {
+    check ^= static_cast<std::uint8_t>(c);
+  }
+  return sentence + std::format("*{:02X}", check);
+}
+
+/// The error scan() reports for @p sample, or nullopt when it passes.
+std::optional<ParseError> error_of(std::string_view sample) {
+  auto sentence = cnmea::tools::scan(sample);
+  return sentence ? std::nullopt : std::optional{sentence.error()};
+}
+
+void valid_sentence() {
+  for (std::string_view sample :
+       {TXT, std::string_view{"$GPTXT,01,01,02,hello*2f"},
+        std::string_view{"$GPTXT,01,01,02,hello*2F\r\n"},
+        std::string_view{"$GPTXT,01,01,02,hello*2F\n"}}) {
+    auto sentence = cnmea::tools::scan(sample);
+    CHECK(sentence.has_value());
+    if (!sentence) {
+      continue;
+    }
+    CHECK(sentence->body == "GPTXT,01,01,02,hello");
+    CHECK(sentence->checksum == 0x2F);
+    CHECK(sentence->tokens.size() == 5);
+    CHECK(sentence->tokens.get(4) == "hello");
+  }
+}
+
+void bad_checksum() {
+  CHECK(error_of("$GPTXT,01,01,02,hello*2E") == ParseError::InvalidChecksum);
+  CHECK(error_of("$GPTXT,01,01,02,hellO*2F") == ParseError::InvalidChecksum);
+}
+
+void malformed_checksum() {
+  // Missing.
+  CHECK(error_of("$GPTXT,01,01,02,hello") == ParseError::InvalidFormat);
+  CHECK(error_of("$GPTXT,01,01,02,hello*") == ParseError::InvalidFormat);
+  CHECK(error_of("$GPTXT,01,01,02,hello*2") == ParseError::InvalidFormat);
+  // Not hexadecimal.
+  CHECK(error_of("$GPTXT,01,01,02,hello*2G") == ParseError::InvalidFormat);
+  CHECK(error_of("$GPTXT,01,01,02,hello*-F") == ParseError::InvalidFormat);
+  // Trailing bytes other than CR/LF.
+  CHECK(error_of("$GPTXT,01,01,02,hello*2F ") == ParseError::InvalidFormat);
+  CHECK(error_of("$GPTXT,01,01,02,hello*2F0") == ParseError::InvalidFormat);
+  CHECK(error_of("$GPTXT,01,01,02,hello*2F\r\nx") ==
+        ParseError::InvalidFormat);
+}
+
+/// MAX_FIELDS fields fit, one more does not, also past the first 64-byte
+/// block.
+void field_capacity() {
+  std::string fields{"$GPTXT"};
+  fields.append(cnmea::tools::MAX_FIELDS - 1, ',');
+
+  auto sentence = cnmea::tools::scan(with_checksum(fields));
+  CHECK(sentence && sentence->tokens.size() == cnmea::tools::MAX_FIELDS);
+
+  CHECK(error_of(with_checksum(fields + ",")) == ParseError::TooManyFields);
+}
+
+/// The body ends at the first `*`; whatever follows must be the checksum.
+void first_star_ends_body() {
+  // The checksum covers only the body before the first star.
+  CHECK(error_of(with_checksum("$GPTXT,01,01,02,hello*2F")) ==
+        ParseError::InvalidFormat);
+  CHECK(error_of("$GPTXT,01*0C,02,hello*2F") == ParseError::InvalidFormat);
+
+  // Commas after the first star do not become fields.
+  auto sentence = cnmea::tools::scan("$GPTXT,01*62");
+  CHECK(sentence && sentence->tokens.size() == 2);
+  CHECK(error_of("$GPTXT,01*62,,") == ParseError::InvalidFormat);
+}
+
+} // namespace
+
+int main() {
+  valid_sentence();
+  bad_checksum();
+  malformed_checksum();
+  field_capacity();
+  first_star_ends_body();
+  return cnmea::test::result();
+}
@@ -0,0 +1,121 @@
+#include "check.h"
+
+#include <array>
+#include <cnmea/simd.h>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+namespace detail = cnmea::simd::detail;
+using cnmea::simd::Block;
+using cnmea::simd::BLOCK;
+
+/// Structural characters, bytes next to them and bytes above 0x7F.
+constexpr std::string_view ALPHABET{",*$!\r\n+)#\x0c\x0e\x80\xaa\xff"
+                                    "GPRMC0123456789.AN"};
+
+bool operator==(const Block &a, const Block &b) {
+  return a.comma == b.comma && a.star == b.star && a.start == b.start &&
+         a.newline == b.newline;
+}
+
+/// Random text drawn mostly from ALPHABET, with some arbitrary bytes.
+std::string random_text(std::mt19937_64 &rng, std::size_t size) {
+  std::uniform_int_distribution<int> byte{0, 255};
+  std::uniform_int_distribution<std::size_t> pick{0, ALPHABET.size() - 1};
+  std::string text(size, '\0');
+  for (char &c : text) {
+    c = byte(rng) < 192 ? ALPHABET[pick(rng)] : static_cast<char>(byte(rng));
+  }
+  return text;
+}
+
+/// Blocks every kernel must agree on.
+std::vector<std::string> blocks() {
+  std::vector<std::string> blocks{std::string(BLOCK, '\0'),
+                                  std::string(BLOCK, '\xff')};
+  for (char c : ALPHABET) {
+    blocks.emplace_back(BLOCK, c);
+    // Only the first byte, the last byte, and the bytes around each 16 and
+    // 32 byte lane boundary.
+    for (std::size_t at : {0, 15, 16, 31, 32, 47, 48, 63}) {
+      std::string block(BLOCK, 'x');
+      block[at] = c;
+      blocks.push_back(block);
+    }
+  }
+
+  std::mt19937_64 rng{2024};
+  for (int i = 0; i < 1000; i++) {
+    blocks.push_back(random_text(rng, BLOCK));
+  }
+  return blocks;
+}
+
+void classify_kernels_agree() {
+  for (const std::string &block : blocks()) {
+    Block expected = detail::classify_scalar(block.data());
+#ifdef CNMEA_SIMD_X86
+    CHECK(detail::classify_sse2(block.data()) == expected);
+    if (__builtin_cpu_supports("avx2")) {
+      CHECK(detail::classify_avx2(block.data()) == expected);
+    }
+#endif
+    CHECK(cnmea::simd::classify(block.data()) == expected);
+  }
+}
+
+/// Every size up to three AVX2 strides, from every offset within one.
+void xor_kernels_agree() {
+  std::mt19937_64 rng{7};
+  const std::string text = random_text(rng, 4 * 32);
+
+  for (std::size_t offset = 0; offset < 32; offset++) {
+    for (std::size_t size = 0; offset + size <= 3 * 32 + 1; size++) {
+      const char *data = text.data() + offset;
+
+      std::uint8_t expected = 0;
+      for (std::size_t i = 0; i < size; i++) {
+        expected ^= static_cast<std::uint8_t>(data[i]);
+      }
+
+      CHECK(detail::xor_scalar(data, size) == expected);
+#ifdef CNMEA_SIMD_X86
+      CHECK(detail::xor_sse2(data, size) == expected);
+      if (__builtin_cpu_supports("avx2")) {
+        CHECK(detail::xor_avx2(data, size) == expected);
+      }
+#endif
+      CHECK(cnmea::simd::xor_reduce({data, size}) == expected);
+    }
+  }
+}
+
+/// Short views are padded, so they classify like their padded copy.
+void short_views_are_padded() {
+  std::mt19937_64 rng{11};
+  for (std::size_t size = 0; size < BLOCK; size++) {
+    std::string text = random_text(rng, size);
+    std::array<char, BLOCK> padded{};
+    text.copy(padded.data(), size);
+    CHECK(cnmea::simd::classify(std::string_view{text}) ==
+          detail::classify_scalar(padded.data()));
+  }
+}
+
+} // namespace
+
+int main() {
+#ifdef CNMEA_SIMD_X86
+  __builtin_cpu_init();
+#endif
+  classify_kernels_agree();
+  xor_kernels_agree();
+  short_views_are_padded();
+  return cnmea::test::result();
+}
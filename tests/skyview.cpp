@@ -0,0 +1,85 @@
+#include "check.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cnmea/cnmea.h>
+#include <cnmea/skyview.h>
+#include <cstddef>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace {
+
+using cnmea::types::Satellite;
+
+/// One GSV cycle of 11 satellites in three fragments.
+constexpr std::array GSV_CYCLE{
+    std::string_view{"$GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,"
+                     "13,06,292,00*74"},
+    std::string_view{"$GPGSV,3,2,11,14,25,170,00,16,57,208,39,18,67,296,40,"
+                     "19,40,246,00*74"},
+    std::string_view{"$GPGSV,3,3,11,22,42,067,42,24,14,311,43,27,05,244,*4D"},
+};
+
+void multi_part_gsv() {
+  cnmea::SkyViewAssembler assembler;
+  std::vector<Satellite> satellites;
+  const cnmea::SkyView *sky = nullptr;
+
+  for (std::string_view sentence : GSV_CYCLE) {
+    auto parsed = cnmea::parse(sentence);
+    CHECK(parsed.has_value());
+    if (!parsed) {
+      return;
+    }
+    const auto &fragment = std::get<cnmea::GSV>(parsed.value());
+    satellites.insert(satellites.end(), fragment.satellites.begin(),
+                      fragment.satellites.end());
+    sky = assembler.push(fragment);
+  }
+
+  CHECK(sky != nullptr);
+  if (sky == nullptr) {
+    return;
+  }
+  CHECK(sky->satellites_in_view == 11);
+  CHECK(std::ranges::equal(sky->view(), satellites));
+
+  // The last fragment's missing SNR is kept as missing.
+  CHECK(satellites.size() == 11 && std::isnan(satellites.back().snr));
+}
+
+/// Each dropped cycle is counted once, also when its head is missing.
+void dropped_gsv_fragments() {
+  cnmea::SkyViewAssembler assembler;
+  auto push = [&](std::size_t index) {
+    auto sky = assembler.push(GSV_CYCLE[index]);
+    CHECK(sky.has_value());
+    return sky ? sky.value() : nullptr;
+  };
+
+  // Headless.
+  CHECK(push(1) == nullptr && push(2) == nullptr);
+  CHECK(assembler.discarded_cycles() == 1);
+
+  // Broken in the middle.
+  CHECK(push(0) == nullptr && push(2) == nullptr);
+  CHECK(assembler.discarded_cycles() == 2);
+
+  // Headless again, right after the broken one.
+  CHECK(push(1) == nullptr && push(2) == nullptr);
+  CHECK(assembler.discarded_cycles() == 3);
+
+  CHECK(push(0) == nullptr && push(1) == nullptr && push(2) != nullptr);
+  CHECK(assembler.discarded_cycles() == 3);
+}
+
+} // namespace
+
+int main() {
+  multi_part_gsv();
+  dropped_gsv_fragments();
+  return cnmea::test::result();
+}
@@ -0,0 +1,185 @@
+#include "check.h"
+
+#include <cnmea/stream.h>
+#include <cstddef>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using cnmea::types::ParseError;
+
+constexpr std::string_view GLL{"$GPGLL,4916.45,N,12311.12,W,225444,A,*1D\r\n"};
+
+/// Whether each sentence parsed, or its error.
+struct Outcomes {
+  std::vector<std::optional<ParseError>> errors;
+
+  void operator()(const cnmea::Result &result) {
+    errors.push_back(result ? std::nullopt
+                            : std::optional<ParseError>{result.error()});
+  }
+};
+
+/// Feeds @p text in chunks of @p size bytes.
+Outcomes feed(std::string_view text, std::size_t size,
+              std::size_t *discarded = nullptr) {
+  cnmea::StreamParser parser;
+  Outcomes outcomes;
+  for (std::size_t at = 0; at < text.size(); at += size) {
+    parser.feed(text.substr(at, size), outcomes);
+  }
+  parser.flush(outcomes);
+  if (discarded != nullptr) {
+    *discarded = parser.discarded_bytes();
+  }
+  return outcomes;
+}
+
+// An overlong sentence is rejected the same way whether it arrives in one
+// chunk or split over many, and the next sentence still parses.
+void overflow_independent_of_chunking() {
+  std::string text{"$GPTXT,"};
+  text.append(cnmea::StreamParser::CAPACITY, 'x');
+  text += "\r\n";
+  text += GLL;
+
+  const std::vector<std::optional<ParseError>> expected{
+      ParseError::BufferOverflow, std::nullopt};
+
+  std::size_t whole_discarded = 0;
+  std::size_t split_discarded = 0;
+  CHECK(feed(text, text.size(), &whole_discarded).errors == expected);
+  CHECK(feed(text, 1, &split_discarded).errors == expected);
+  CHECK(feed(text, 100).errors == expected);
+  CHECK(whole_discarded == split_discarded);
+}
+
+// A sentence of exactly CAPACITY bytes still fits.
+void longest_sentence_fits() {
+  std::string text{GLL.substr(0, GLL.size() - 2)};
+  std::string padded = text;
+  padded.resize(cnmea::StreamParser::CAPACITY, ',');
+
+  // Not valid NMEA, but not an overflow either.
+  auto whole = feed(padded + "\r\n", padded.size() + 2);
+  auto split = feed(padded + "\r\n", 1);
+  CHECK(whole.errors.size() == 1 &&
+        whole.errors.front() != ParseError::BufferOverflow);
+  CHECK(whole.errors == split.errors);
+}
+
+/// Feeds each of @p chunks in turn.
+Outcomes feed(std::initializer_list<std::string_view> chunks,
+              cnmea::StreamParser &parser) {
+  Outcomes outcomes;
+  for (std::string_view chunk : chunks) {
+    parser.feed(chunk, outcomes);
+  }
+  return outcomes;
+}
+
+const std::vector<std::optional<ParseError>> ONE_SENTENCE{std::nullopt};
+
+// A sentence split into two or three chunks at every pair of offsets
+// parses as if it came whole.
+void split_at_every_offset() {
+  for (std::size_t first = 0; first <= GLL.size(); first++) {
+    for (std::size_t second = first; second <= GLL.size(); second++) {
+      cnmea::StreamParser parser;
+      auto outcomes = feed({GLL.substr(0, first),
+                            GLL.substr(first, second - first),
+                            GLL.substr(second)},
+                           parser);
+      CHECK(outcomes.errors == ONE_SENTENCE);
+      CHECK(parser.pending() == 0 && parser.discarded_bytes() == 2);
+    }
+  }
+}
+
+// A start character ends the sentence before it, buffered or not.
+void start_restarts_frame() {
+  auto cut_then_whole = [](const Outcomes &outcomes) {
+    return outcomes.errors.size() == 2 && outcomes.errors[0].has_value() &&
+           !outcomes.errors[1].has_value();
+  };
+
+  cnmea::StreamParser split;
+  CHECK(cut_then_whole(feed({"$GPGLL,4916.4", GLL}, split)));
+
+  cnmea::StreamParser whole;
+  std::string text{"$GPGLL,4916.4"};
+  text += GLL;
+  CHECK(cut_then_whole(feed({text}, whole)));
+
+  cnmea::StreamParser ais;
+  CHECK(feed({"$GPGLL,4916.4", "5,N!AIVDM"}, ais).errors.size() == 1);
+  CHECK(ais.pending() == std::string_view{"!AIVDM"}.size());
+}
+
+// CR, LF and CRLF all end a sentence, and none adds an empty one.
+void line_terminators() {
+  const std::string_view body = GLL.substr(0, GLL.size() - 2);
+  std::string text;
+  text += body;
+  text += '\r';
+  text += body;
+  text += '\n';
+  text += body;
+  text += "\r\n";
+
+  for (std::size_t size : {text.size(), std::size_t{1}, std::size_t{7}}) {
+    std::size_t discarded = 0;
+    auto outcomes = feed(text, size, &discarded);
+    CHECK(outcomes.errors.size() == 3);
+    CHECK(outcomes.errors == std::vector<std::optional<ParseError>>(3));
+    CHECK(discarded == 4);
+  }
+}
+
+// Bytes outside any sentence are counted, terminators included.
+void leading_noise() {
+  std::string text{"\x00\xffnoise,*"};
+  const std::size_t noise = text.size();
+  text += GLL;
+
+  std::size_t discarded = 0;
+  CHECK(feed(text, text.size(), &discarded).errors == ONE_SENTENCE);
+  CHECK(discarded == noise + 2);
+  CHECK(feed(text, 3, &discarded).errors == ONE_SENTENCE);
+  CHECK(discarded == noise + 2);
+}
+
+// A sentence without a terminator waits in the buffer until flush().
+void flush_trailing_partial() {
+  const std::string_view body = GLL.substr(0, GLL.size() - 2);
+  cnmea::StreamParser parser;
+
+  CHECK(feed({body.substr(0, 10), body.substr(10)}, parser).errors.empty());
+  CHECK(parser.pending() == body.size());
+
+  Outcomes outcomes;
+  parser.flush(outcomes);
+  CHECK(outcomes.errors == ONE_SENTENCE);
+  CHECK(parser.pending() == 0);
+
+  // Nothing left to flush.
+  parser.flush(outcomes);
+  CHECK(outcomes.errors.size() == 1);
+}
+
+} // namespace
+
+int main() {
+  overflow_independent_of_chunking();
+  longest_sentence_fits();
+  split_at_every_offset();
+  start_restarts_frame();
+  line_terminators();
+  leading_noise();
+  flush_trailing_partial();
+  return cnmea::test::result();
+}
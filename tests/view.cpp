@@ -0,0 +1,73 @@
+#include "check.h"
+
+#include <cnmea/gga.h>
+#include <string>
+#include <string_view>
+
+namespace {
+
+using cnmea::types::Direction;
+using cnmea::types::FixQuality;
+using cnmea::types::ParseError;
+
+constexpr std::string_view GGA{
+    "$GPGGA,123519.00,4807.038000,N,01131.000000,E,1,08,0.9,545.4,M,46.9,M,,"
+    "*69"};
+/// A fix quality no receiver sends, with a valid checksum.
+constexpr std::string_view BAD_QUALITY{
+    "$GPGGA,123519.00,4807.038000,N,01131.000000,E,X,08,0.9,545.4,M,46.9,M,,"
+    "*00"};
+
+/// A decoded field is kept: later calls return it without reading the
+/// sentence again.
+void second_get_is_cached() {
+  std::string text{GGA};
+  auto view = cnmea::gga::view(text);
+  CHECK(view.has_value());
+  if (!view) {
+    return;
+  }
+
+  const auto &latitude = view->latitude();
+  CHECK(latitude && latitude->get_direction() == Direction::North);
+
+  // Overwrite the hemisphere in place; the cached value does not follow.
+  text[text.find(",N,") + 1] = 'S';
+  CHECK(&view->latitude() == &latitude);
+  CHECK(view->latitude()->get_direction() == Direction::North);
+
+  // A field not read before still decodes from the sentence.
+  CHECK(view->hdop() == 0.9);
+}
+
+/// A field that fails to decode reports its error on access only.
+void bad_field_reports_on_access() {
+  auto view = cnmea::gga::view(BAD_QUALITY);
+  CHECK(view.has_value());
+  if (!view) {
+    return;
+  }
+
+  auto quality = view->fix_quality();
+  CHECK(!quality && quality.error() == ParseError::InvalidFixQuality);
+  // Cached errors are reported again.
+  CHECK(view->fix_quality().error() == ParseError::InvalidFixQuality);
+
+  // Other fields are unaffected.
+  CHECK(view->num_satellites() == 8);
+  CHECK(view->latitude().has_value());
+
+  auto decoded = view->decode();
+  CHECK(!decoded && decoded.error() == ParseError::InvalidFixQuality);
+
+  auto good = cnmea::gga::view(GGA);
+  CHECK(good && good->fix_quality() == FixQuality::GPS);
+}
+
+} // namespace
+
+int main() {
+  second_get_is_cached();
+  bad_field_reports_on_access();
+  return cnmea::test::result();
+}